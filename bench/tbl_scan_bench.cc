@@ -0,0 +1,139 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+// .tbl ingestion microbenchmark.
+// Writes a synthetic tab-separated file (CRLF lines of 10 integers), then
+// times the legacy std::getline + wstringstream path against
+// TableDataStructure::ParseRows with every TblScanner level this CPU runs.
+// Exits non-zero if a SIMD level's rows or checksum differ from the scalar run.
+//
+// usage: tbl_scan_bench [size_mb=1024] [path=tbl_scan_bench.tbl]
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DataProcessor/tbl_data_structure.h"
+#include "Utility/mapped_file.h"
+#include "Utility/string_utils.h"
+#include "Utility/tbl_scanner.h"
+
+namespace {
+constexpr int kColumns = 10;
+
+void WriteSyntheticFile(const std::string& path, size_t target_bytes) {
+  std::ofstream out(path, std::ios::binary);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> small(0, 999);
+  std::uniform_int_distribution<int> large(0, 99999999);
+  std::string line;
+  size_t written = 0;
+  while (written < target_bytes) {
+    line.clear();
+    for (int col = 0; col < kColumns; ++col) {
+      if (col > 0) {
+        line += '\t';
+      }
+      line += std::to_string(col == 4 ? large(rng) : small(rng));
+    }
+    line += "\r\n";
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    written += line.size();
+  }
+}
+
+// Sum of every value, so each run can be checked against the others.
+int64_t Checksum(const TableData& rows) {
+  int64_t sum = 0;
+  for (const auto& row : rows) {
+    for (int value : row) {
+      sum += value;
+    }
+  }
+  return sum;
+}
+
+void Report(const char* name, double seconds, size_t bytes, size_t rows, int64_t checksum) {
+  printf("%-22s %8.3f s %9.1f MB/s  rows %zu  checksum %lld\n", name, seconds,
+         static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds, rows, static_cast<long long>(checksum));
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t size_mb = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+  std::string path = argc > 2 ? argv[2] : "tbl_scan_bench.tbl";
+
+  printf("Writing %zu MB to %s\n", size_mb, path.c_str());
+  WriteSyntheticFile(path, size_mb * 1024 * 1024);
+
+  MappedFile file(path);
+  if (!file.IsOpen()) {
+    fprintf(stderr, "Failed to map %s\n", path.c_str());
+    return 1;
+  }
+  size_t bytes = file.View().size();
+
+  // Legacy path: getline, Ctw, then TableDataStructure's wstringstream tokenizer
+  {
+    auto start = std::chrono::steady_clock::now();
+    TableDataStructure table(nullptr);
+    std::any context = table.CreateContext();
+    std::wstring key = L"bench";
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+      std::vector<std::any> args{Ctw(line)};
+      table.ConstructDataStructure(context, args, key);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const auto& rows = std::any_cast<const TableDataStructure::TableDataMap&>(context).at(key);
+    // The legacy path drops the last column of CRLF lines, so its checksum differs
+    Report("getline+wstringstream", elapsed.count(), bytes, rows.size(), Checksum(rows));
+  }
+
+  // In-place scan, once per instruction set up to the widest one available.
+  // Scalar runs first and is the reference for the SIMD kernels.
+  int status = 0;
+  size_t scalar_rows = 0;
+  int64_t scalar_checksum = 0;
+  TblScanner::SimdLevel widest = TblScanner::DetectSimdLevel();
+  for (auto level : {TblScanner::SimdLevel::SCALAR, TblScanner::SimdLevel::SSE42, TblScanner::SimdLevel::AVX2}) {
+    if (static_cast<int>(level) > static_cast<int>(widest)) {
+      break;
+    }
+    auto start = std::chrono::steady_clock::now();
+    TableData rows;
+    TableDataStructure::ParseRows(file.View(), rows, TblScanner::ForLevel(level));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::string name = "ParseRows " + Cts(TblScanner::SimdLevelName(level));
+    int64_t checksum = Checksum(rows);
+    Report(name.c_str(), elapsed.count(), bytes, rows.size(), checksum);
+    if (level == TblScanner::SimdLevel::SCALAR) {
+      scalar_rows = rows.size();
+      scalar_checksum = checksum;
+    } else if (rows.size() != scalar_rows || checksum != scalar_checksum) {
+      fprintf(stderr, "%s disagrees with scalar: rows %zu vs %zu, checksum %lld vs %lld\n", name.c_str(),
+              rows.size(), scalar_rows, static_cast<long long>(checksum), static_cast<long long>(scalar_checksum));
+      status = 1;
+    }
+  }
+
+  std::remove(path.c_str());
+  return status;
+}
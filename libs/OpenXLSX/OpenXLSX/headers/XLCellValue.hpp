@@ -564,6 +564,14 @@ namespace OpenXLSX
          */
         std::string typeAsString() const;
 
+        /**
+         * @brief get the shared string index of value
+         * @return the index in the shared strings table
+         * @return -1 if cell value is not a shared string
+         * @note public so that readers can resolve the string via XLSharedStrings::getString without copying it
+         */
+        int32_t stringIndex() const;
+
         /**
          * @brief Implicitly convert the XLCellValueProxy object to a XLCellValue object.
          * @return An XLCellValue object, corresponding to the cell value.
@@ -659,13 +667,6 @@ namespace OpenXLSX
          */
         XLCellValue getValue() const;
 
-        /**
-         * @brief get the shared string index of value
-         * @return the index in the shared strings table
-         * @return -1 if cell value is not a shared string
-         */
-        int32_t stringIndex() const;
-
         /**
          * @brief directly set the shared string index for cell, bypassing XLSharedStrings
          * @return true if newIndex could be set
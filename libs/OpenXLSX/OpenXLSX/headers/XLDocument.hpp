@@ -55,6 +55,8 @@ YM      M9  MM    MM MM       MM    MM   d'  `MM.    MM            MM   d'  `MM.
 // ===== External Includes ===== //
 #include <algorithm> // std::find_if
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 
 // ===== OpenXLSX Includes ===== //
@@ -440,6 +442,7 @@ namespace OpenXLSX
 
         mutable std::list<XLXmlData>    m_data {};              /**<  */
         mutable std::deque<std::string> m_sharedStringCache {}; /**<  */
+        mutable XLSharedStringIndex     m_sharedStringIndex {}; /**< string_view lookup into m_sharedStringCache */
         mutable XLSharedStrings         m_sharedStrings {};     /**<  */
 
         XLRelationships m_docRelationships {}; /**< A pointer to the document relationships object*/
@@ -450,6 +453,7 @@ namespace OpenXLSX
         XLStyles        m_styles {};           /**< A pointer to the document styles object*/
         XLWorkbook      m_workbook {};         /**< A pointer to the workbook object */
         IZipArchive     m_archive {};          /**<  */
+        std::unique_ptr<std::mutex> m_archiveMutex { std::make_unique<std::mutex>() }; /**< Serializes archive reads when XML parts are loaded from several threads */
     };
 
 
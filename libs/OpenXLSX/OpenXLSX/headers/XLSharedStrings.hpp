@@ -57,6 +57,8 @@ YM      M9  MM    MM MM       MM    MM   d'  `MM.    MM            MM   d'  `MM.
 #include <limits>     // std::numeric_limits
 #include <ostream>    // std::basic_ostream
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 // ===== OpenXLSX Includes ===== //
 #include "OpenXLSX-Exports.hpp"
@@ -67,6 +69,12 @@ namespace OpenXLSX
     constexpr size_t XLMaxSharedStrings = (std::numeric_limits< int32_t >::max)();    // pull request #261: wrapped max in parentheses to prevent expansion of windows.h "max" macro
 
     class XLSharedStrings; // forward declaration
+
+    /**
+     * @brief Hash index from shared string content to its first index in the shared string cache. Keys are views into
+     * the cache entries, which is safe because std::deque::emplace_back never relocates existing elements.
+     */
+    using XLSharedStringIndex = std::unordered_map<std::string_view, int32_t>;
     typedef std::reference_wrapper< const XLSharedStrings > XLSharedStringsRef;
 
     extern const XLSharedStrings XLSharedStringsDefaulted; // to be used for default initialization of all references of type XLSharedStrings
@@ -95,8 +103,9 @@ namespace OpenXLSX
          * @brief
          * @param xmlData
          * @param stringCache
+         * @param stringIndex index over stringCache, (re)built by this constructor
          */
-        explicit XLSharedStrings(XLXmlData* xmlData, std::deque<std::string>* stringCache);
+        explicit XLSharedStrings(XLXmlData* xmlData, std::deque<std::string>* stringCache, XLSharedStringIndex* stringIndex);
 
         /**
          * @brief Destructor
@@ -193,7 +202,13 @@ namespace OpenXLSX
         int32_t rewriteXmlFromCache();
 
     private:
+        /**
+         * @brief rebuild m_stringIndex from the full contents of m_stringCache
+         */
+        void rebuildIndex() const;
+
         std::deque<std::string>* m_stringCache {}; /** < Each string must have an unchanging memory address; hence the use of std::deque */
+        XLSharedStringIndex*     m_stringIndex {}; /** < Owned by XLDocument alongside m_stringCache, kept in sync by all modifiers */
     };
 }    // namespace OpenXLSX
 
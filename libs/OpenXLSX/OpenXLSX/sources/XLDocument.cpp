@@ -619,7 +619,7 @@ void XLDocument::open(const std::string& fileName)
     // ===== 2024-09-02: ensure that all worksheets are contained in app.xml <TitlesOfParts> and reflected in <HeadingPairs> value for Worksheets
     m_appProperties.alignWorksheets(m_workbook.sheetNames());
 
-    m_sharedStrings  = XLSharedStrings(getXmlData("xl/sharedStrings.xml"), &m_sharedStringCache);
+    m_sharedStrings  = XLSharedStrings(getXmlData("xl/sharedStrings.xml"), &m_sharedStringCache, &m_sharedStringIndex);
     m_styles         = XLStyles(getXmlData("xl/styles.xml"), m_suppressWarnings); // 2024-10-14: forward supress warnings setting to XLStyles
 }
 
@@ -712,6 +712,7 @@ void XLDocument::close()
     m_xmlSavingDeclaration = XLXmlSavingDeclaration();
 
     m_data.clear();
+    m_sharedStringIndex.clear();             // views into m_sharedStringCache, clear first
     m_sharedStringCache.clear();             // 2024-12-18 BUGFIX: clear shared strings cache - addresses issue #283
     m_sharedStrings    = XLSharedStrings();  //
 
@@ -1499,6 +1500,7 @@ void XLDocument::cleanupSharedStrings()
         if (int32_t newIdx = indexMap[oldIdx]; newIdx > 0)           // if string is still in use
             newStringCache[newIdx] = std::move(m_sharedStringCache[oldIdx]); // NOTE: std::move invalidates the shared string cache -> not thread safe
     }
+    m_sharedStringIndex.clear(); // keys view the strings that were just moved out; rewriteXmlFromCache rebuilds the index
     m_sharedStringCache.clear(); // TBD: is this safe with strings that were std::move assigned to newStringCache?
     // refill m_sharedStringCache cache from newStringCache
     std::move(
@@ -1515,10 +1517,12 @@ void XLDocument::cleanupSharedStrings()
 //----------------------------------------------------------------------------------------------------------------------
 
 /**
- * @details
+ * @details The archive itself is not thread-safe; the lock lets distinct XLXmlData objects (e.g. different worksheets)
+ * be loaded and parsed concurrently, with only the decompression step serialized.
  */
 std::string XLDocument::extractXmlFromArchive(const std::string& path)
 {
+    std::lock_guard<std::mutex> lock(*m_archiveMutex);
     return (m_archive.hasEntry(path) ? m_archive.getEntry(path) : "");
 }
 
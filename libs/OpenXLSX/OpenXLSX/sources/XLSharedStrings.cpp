@@ -63,9 +63,10 @@ using namespace OpenXLSX;
  * @details Constructs a new XLSharedStrings object. Only one (common) object is allowed per XLDocument instance.
  * A filepath to the underlying XML file must be provided.
  */
-XLSharedStrings::XLSharedStrings(XLXmlData* xmlData, std::deque<std::string>* stringCache)
+XLSharedStrings::XLSharedStrings(XLXmlData* xmlData, std::deque<std::string>* stringCache, XLSharedStringIndex* stringIndex)
     : XLXmlFile(xmlData),
-      m_stringCache(stringCache)
+      m_stringCache(stringCache),
+      m_stringIndex(stringIndex)
 {
     XMLDocument & doc = xmlDocument();
     if (doc.document_element().empty())    // handle a bad (no document element) xl/sharedStrings.xml
@@ -80,6 +81,7 @@ XLSharedStrings::XLSharedStrings(XLXmlData* xmlData, std::deque<std::string>* st
                 "</sst>",
                 pugi_parse_settings
         );
+    rebuildIndex();    // XLDocument fills the string cache before constructing this object
 }
 
 /**
@@ -89,12 +91,13 @@ XLSharedStrings::~XLSharedStrings() = default;
 
 /**
  * @details Look up a string index by the string content. If the string does not exist, the returned index is -1.
+ * If the string occurs more than once in the cache, the lowest index is returned.
  */
 int32_t XLSharedStrings::getStringIndex(const std::string& str) const
 {
-    const auto iter = std::find_if(m_stringCache->begin(), m_stringCache->end(), [&](const std::string& s) { return str == s; });
+    const auto iter = m_stringIndex->find(str);
 
-    return iter == m_stringCache->end() ? -1 : static_cast<int32_t>(std::distance(m_stringCache->begin(), iter));
+    return iter == m_stringIndex->end() ? -1 : iter->second;
 }
 
 /**
@@ -131,6 +134,7 @@ int32_t XLSharedStrings::appendString(const std::string& str) const
         textNode.append_attribute("xml:space").set_value("preserve");    // pull request #161
     textNode.text().set(str.c_str());
     m_stringCache->emplace_back(textNode.text().get());    // index of this element = previous stringCacheSize
+    m_stringIndex->emplace(m_stringCache->back(), static_cast<int32_t>(stringCacheSize));    // no-op if str was already cached
 
     return static_cast<int32_t>(stringCacheSize);
 }
@@ -153,6 +157,7 @@ void XLSharedStrings::clearString(int32_t index) const   // 2024-04-30: whitespa
     }
 
     (*m_stringCache)[index] = "";
+    rebuildIndex();    // the cleared string may be duplicated at a higher index, and "" may now map to a lower one
     // auto iter            = xmlDocument().document_element().children().begin();
     // std::advance(iter, index);
     // iter->text().set(""); // 2024-04-30: BUGFIX: this was never going to work, <si> entries can be plenty that need to be cleared,
@@ -189,5 +194,17 @@ int32_t XLSharedStrings::rewriteXmlFromCache()
         textNode.text().set(s.c_str());
         ++writtenStrings;
     }
+    rebuildIndex();
     return writtenStrings;
 }
+
+/**
+ * @details Walk the cache front to back so that emplace keeps the first occurrence of each string.
+ */
+void XLSharedStrings::rebuildIndex() const
+{
+    m_stringIndex->clear();
+    m_stringIndex->reserve(m_stringCache->size());
+    int32_t index = 0;
+    for (const std::string& s : *m_stringCache) m_stringIndex->emplace(s, index++);
+}
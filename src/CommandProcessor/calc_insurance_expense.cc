@@ -21,11 +21,12 @@
 #include "Logger/logger.h"
 #include "Utility/excel_utils.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
 
 void CalcInsuranceExpenseCommand::Execute(const YAML::Node &command_data) {
   std::wstring file_name = Ctw(command_data["name"].as<std::string>());
   std::vector<int> ranges;
-  Logger::Log(L"Calculating insurance expense from %ls\n", file_name.c_str());
+  LOG_INFO(L"Calculating insurance expense from %ls\n", file_name.c_str());
   std::shared_ptr<InsuranceResultIndex> result =
       std::make_shared<InsuranceResultIndex>();
   if (command_data["variables"]) {
@@ -56,7 +57,7 @@ void CalcInsuranceExpenseCommand::Execute(const YAML::Node &command_data) {
       }
     }
     std::vector<std::any> args = {result};
-    data_helper_->ExecuteData(L"InsuranceResult", file_name, L"InsuranceResult", args);
-    data_helper_->PrintData(L"InsuranceResult");
+    data_helper_->ExecuteData(Symbols::kInsuranceResult, file_name, Symbols::kInsuranceResult, args);
+    data_helper_->PrintData(Symbols::kInsuranceResult);
   }
 }
@@ -21,6 +21,7 @@
 #include "Logger/logger.h"
 #include "Utility/abort.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
 std::vector<std::wstring>
 CalcInsuranceOutputCommand::SplitAndConvertToWString(const std::string &input) {
   std::vector<std::wstring> result;
@@ -76,7 +77,7 @@ void CalcInsuranceOutputCommand::ProcessVariables(const YAML::Node &variables_no
         }
       }
     } else {
-      Logger::Log(L"Unknown variable name: %s\n", name.c_str());
+      LOG_WARN(L"Unknown variable name: %s\n", name.c_str());
     }
   }
 }
@@ -85,7 +86,7 @@ void CalcInsuranceOutputCommand::ProcessFile(const std::wstring &file_name,
                                              const YAML::Node &variables_node,
                                              InsuranceOutputIndex &insurance_output_result_index) {
   auto insurance_result_data_structure =
-      data_helper_->GetDataStructure(file_name + L"InsuranceResult");
+      data_helper_->GetDataStructure(SymbolTable::Intern(file_name + L"InsuranceResult"));
 
   if (variables_node) {
     ProcessVariables(variables_node, insurance_output_result_index, file_name);
@@ -99,11 +100,11 @@ void CalcInsuranceOutputCommand::Execute(const YAML::Node &command_data) {
   // Check if new format with "files" array
   if (command_data["name"]) {
     // Legacy format with single "name" and "variables"
-    Logger::Log(L"Processing single file (legacy format)\n");
+    LOG_INFO(L"Processing single file (legacy format)\n");
     primary_file_name = Ctw(command_data["name"].as<std::string>());
     for (const auto &file_node : command_data["variables"]) {
       std::wstring file_name = Ctw(file_node["name"].as<std::string>());
-      Logger::Log(L"Processing file: %ls\n", file_name.c_str());
+      LOG_INFO(L"Processing file: %ls\n", file_name.c_str());
       ProcessFile(file_name, file_node["variables"], insurance_output_result_index);
     }
   } else {
@@ -112,6 +113,6 @@ void CalcInsuranceOutputCommand::Execute(const YAML::Node &command_data) {
 
   // Execute and print data once after processing all files
   std::vector<std::any> args = {insurance_output_result_index};
-  data_helper_->ExecuteData(+L"InsuranceOutput", primary_file_name, L"InsuranceOutput", args);
-  data_helper_->PrintData(+L"InsuranceOutput");
+  data_helper_->ExecuteData(Symbols::kInsuranceOutput, primary_file_name, Symbols::kInsuranceOutput, args);
+  data_helper_->PrintData(Symbols::kInsuranceOutput);
 }
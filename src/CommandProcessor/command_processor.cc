@@ -23,14 +23,14 @@
 
 void CommandHelper::RegisterAllCommands() {
   // Pre-register all commands at initialization time (thread-safe: only called in constructor)
-  command_instances_[L"environments"] =
+  command_instances_[SymbolTable::Intern(L"environments")] =
       std::make_shared<EnvironmentsCommand>(data_helper_);
-  command_instances_[L"read_excel"] =
+  command_instances_[SymbolTable::Intern(L"read_excel")] =
       std::make_shared<ReadExcelCommand>(data_helper_);
-  command_instances_[L"read_tbl"] =
+  command_instances_[SymbolTable::Intern(L"read_tbl")] =
       std::make_shared<ReadTblCommand>(data_helper_);
-  command_instances_[L"calc_insurance_expense"] =
+  command_instances_[SymbolTable::Intern(L"calc_insurance_expense")] =
       std::make_shared<CalcInsuranceExpenseCommand>(data_helper_);
-  command_instances_[L"calc_insurance_output"] =
+  command_instances_[SymbolTable::Intern(L"calc_insurance_output")] =
       std::make_shared<CalcInsuranceOutputCommand>(data_helper_);
 }
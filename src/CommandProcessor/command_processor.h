@@ -20,6 +20,7 @@
 #include <yaml-cpp/yaml.h>
 
 #include "DataProcessor/data_helper.h"
+#include "Utility/symbol_table.h"
 class ICommand {
  public:
   virtual void Execute(const YAML::Node& command_data) = 0;
@@ -46,20 +47,22 @@ class CommandHelper {
   }
   ~CommandHelper() = default;
 
-  void ExecuteCommand(const std::wstring& command_name,
-                      const std::wstring& /*name*/, const YAML::Node& command_data) {
+  void ExecuteCommand(Symbol command_name, Symbol /*name*/, const YAML::Node& command_data) {
     // All commands are pre-initialized, just look up and execute
     auto it = command_instances_.find(command_name);
     if (it != command_instances_.end()) {
       it->second->Execute(command_data);
     } else {
-      Logger::Log(L"Unknown command %ls\n", command_name.c_str());
+      LOG_WARN(L"Unknown command %ls\n", command_name.Name().c_str());
     }
   }
 
+  // Logs how much the run's contexts allocated from the context arena.
+  void LogArenaStats() const { data_helper_->LogArenaStats(); }
+
  private:
   std::shared_ptr<DataHelper> data_helper_;
-  std::unordered_map<std::wstring, std::shared_ptr<BaseCommand>>
+  std::unordered_map<Symbol, std::shared_ptr<BaseCommand>>
       command_instances_;
   std::atomic<bool> commands_initialized_;  // Lock-free initialization flag
 
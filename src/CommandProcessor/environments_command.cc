@@ -18,12 +18,13 @@
 #include "Environments/global_environment.h"
 #include "Logger/logger.h"
 #include "Utility/string_utils.h"
+#include "Utility/thread_pool.h"
 
 void EnvironmentsCommand::Execute(const YAML::Node& command_data) {
   if (command_data["name"] && command_data["name"].as<std::string>() == "core_type") {
     if (command_data["value"]) {
       std::string core_type = command_data["value"].as<std::string>();
-      Logger::Log(L"[ENV] core_type: %ls\n", Ctw(core_type).c_str());
+      LOG_INFO(L"[ENV] core_type: %ls\n", Ctw(core_type).c_str());
 
       Environments::ExecutionMode core_mode = Environments::ExecutionMode::MULTI_THREAD;
       if (core_type == "single") {
@@ -35,5 +36,91 @@ void EnvironmentsCommand::Execute(const YAML::Node& command_data) {
       }
       Environments::GlobalEnvironment::GetInstance().SetCoreType(core_mode);
     }
+  } else if (command_data["name"] && command_data["name"].as<std::string>() == "read_mode") {
+    if (command_data["value"]) {
+      std::string read_mode = command_data["value"].as<std::string>();
+      LOG_INFO(L"[ENV] read_mode: %ls\n", Ctw(read_mode).c_str());
+
+      Environments::ReadMode mode = Environments::ReadMode::CELL;
+      if (read_mode == "cell") {
+        mode = Environments::ReadMode::CELL;
+      } else if (read_mode == "stream") {
+        mode = Environments::ReadMode::STREAM;
+      }
+      Environments::GlobalEnvironment::GetInstance().SetReadMode(mode);
+    }
+  } else if (command_data["name"] && command_data["name"].as<std::string>() == "max_inflight_batches") {
+    if (command_data["value"]) {
+      int count = command_data["value"].as<int>();
+      LOG_INFO(L"[ENV] max_inflight_batches: %d\n", count);
+
+      if (count > 0) {
+        Environments::GlobalEnvironment::GetInstance().SetMaxInflightBatches(static_cast<size_t>(count));
+      } else {
+        LOG_WARN(L"Warning: max_inflight_batches must be positive, keeping %zu\n",
+                 Environments::GlobalEnvironment::GetInstance().GetMaxInflightBatches());
+      }
+    }
+  } else if (command_data["name"] && command_data["name"].as<std::string>() == "snapshot_dir") {
+    if (command_data["value"]) {
+      std::string snapshot_dir = command_data["value"].as<std::string>();
+      LOG_INFO(L"[ENV] snapshot_dir: %ls\n", Ctw(snapshot_dir).c_str());
+      Environments::GlobalEnvironment::GetInstance().SetSnapshotDir(snapshot_dir);
+    }
+  } else if (command_data["name"] && command_data["name"].as<std::string>() == "log_level") {
+    if (command_data["value"]) {
+      std::string log_level = command_data["value"].as<std::string>();
+      LOG_INFO(L"[ENV] log_level: %ls\n", Ctw(log_level).c_str());
+
+      if (log_level == "trace") {
+        Logger::SetLevel(LogLevel::TRACE);
+      } else if (log_level == "debug") {
+        Logger::SetLevel(LogLevel::DEBUG);
+      } else if (log_level == "info") {
+        Logger::SetLevel(LogLevel::INFO);
+      } else if (log_level == "warn") {
+        Logger::SetLevel(LogLevel::WARN);
+      } else if (log_level == "error") {
+        Logger::SetLevel(LogLevel::ERROR);
+      } else {
+        LOG_WARN(L"Warning: unknown log_level %ls, keeping the current level\n", Ctw(log_level).c_str());
+      }
+    }
+  } else if (command_data["name"] && command_data["name"].as<std::string>() == "worker_threads") {
+    if (command_data["value"]) {
+      int count = command_data["value"].as<int>();
+      LOG_INFO(L"[ENV] worker_threads: %d\n", count);
+
+      if (count >= 0) {
+        Environments::GlobalEnvironment::GetInstance().SetWorkerThreads(static_cast<size_t>(count));
+      } else {
+        LOG_WARN(L"Warning: worker_threads must not be negative, keeping %zu\n",
+                 Environments::GlobalEnvironment::GetInstance().GetWorkerThreads());
+      }
+      WarnIfPoolStarted("worker_threads");
+    }
+  } else if (command_data["name"] && command_data["name"].as<std::string>() == "thread_placement") {
+    if (command_data["value"]) {
+      std::string thread_placement = command_data["value"].as<std::string>();
+      LOG_INFO(L"[ENV] thread_placement: %ls\n", Ctw(thread_placement).c_str());
+
+      Environments::ThreadPlacement placement = Environments::ThreadPlacement::NONE;
+      if (thread_placement == "none") {
+        placement = Environments::ThreadPlacement::NONE;
+      } else if (thread_placement == "compact") {
+        placement = Environments::ThreadPlacement::COMPACT;
+      } else if (thread_placement == "spread") {
+        placement = Environments::ThreadPlacement::SPREAD;
+      }
+      Environments::GlobalEnvironment::GetInstance().SetThreadPlacement(placement);
+      WarnIfPoolStarted("thread_placement");
+    }
+  }
+}
+
+// The pool reads its environments once, when it starts
+void EnvironmentsCommand::WarnIfPoolStarted(const std::string& name) {
+  if (ThreadPool::IsInstanceStarted()) {
+    LOG_WARN(L"Warning: %ls is set after the thread pool started and has no effect\n", Ctw(name).c_str());
   }
 }
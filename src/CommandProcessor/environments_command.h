@@ -15,6 +15,7 @@
 #define SRC_COMMANDPROCESSOR_ENVIRONMENTS_COMMAND_H_
 
 #include <memory>
+#include <string>
 
 #include "CommandProcessor/command_processor.h"
 
@@ -23,6 +24,9 @@ class EnvironmentsCommand : public BaseCommand {
   explicit EnvironmentsCommand(std::shared_ptr<DataHelper> helper)
       : BaseCommand(helper) {}
   void Execute(const YAML::Node& command_data) override;
+
+ private:
+  static void WarnIfPoolStarted(const std::string& name);
 };
 
 #endif  // SRC_COMMANDPROCESSOR_ENVIRONMENTS_COMMAND_H_
@@ -14,141 +14,191 @@
 #include "CommandProcessor/read_excel.h"
 
 #include <OpenXLSX.hpp>
+#include <unordered_map>
+#include <vector>
 
+#include "DataProcessor/snapshot.h"
 #include "Environments/global_environment.h"
 #include "Logger/logger.h"
 #include "Utility/abort.h"
+#include "Utility/bounded_queue.h"
 #include "Utility/excel_utils.h"
+#include "Utility/parallel.h"
+#include "Utility/sheet_row_cursor.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
 #include "Utility/thread_pool.h"
 
 #ifdef CUDA_ENABLED
 #include "Utility/cuda_processor.h"
 #endif
-std::wstring
-ReadExcelCommand::get_cell_value(const OpenXLSX::XLCellValue& cell_value) {
-  std::wstring type = Ctw(cell_value.typeAsString());
-  if (type == L"integer") {
-    return Ctw(std::to_string(cell_value.get<int>()));
-  } else if (type == L"float") {
-    return Ctw(std::to_string(cell_value.get<double>()));
-  } else if (type == L"string") {
-    return Ctw(cell_value.get<std::string>());
-  } else {
-    return L"";
+CellValue ReadExcelCommand::GetCellValue(const OpenXLSX::XLCellValueProxy& cell_value,
+                                         const OpenXLSX::XLSharedStrings& shared_strings,
+                                         CellRow& row) {
+  switch (cell_value.type()) {
+    case OpenXLSX::XLValueType::Integer:
+      return CellValue(cell_value.get<int64_t>());
+    case OpenXLSX::XLValueType::Float:
+      return CellValue(cell_value.get<double>());
+    case OpenXLSX::XLValueType::String: {
+      // Shared strings are viewed in place; anything else is copied once into the row
+      int32_t index = cell_value.stringIndex();
+      if (index >= 0) {
+        return CellValue(std::string_view(shared_strings.getString(index)));
+      }
+      row.owned_strings.push_back(std::make_unique<std::string>(cell_value.get<std::string>()));
+      return CellValue(std::string_view(*row.owned_strings.back()));
+    }
+    default:
+      return CellValue();
   }
 }
 
-void ReadExcelCommand::ProcessRow(const std::vector<std::pair<int, std::wstring>>& cells, const std::wstring& sheet_name, const std::wstring& sheet_type, std::any* context) {
-  std::wstring key = L"";
-  for (const auto& [col, cell_string] : cells) {
-    if (cell_string.empty()) {
-      continue;
+void ReadExcelCommand::ProcessRows(const CellRowSpan& rows, DataHelper::Handle handle, std::any* context) {
+  data_helper_->ExecuteRows(handle, rows, L"", context);
+}
+
+template <typename RowHandler>
+void ReadExcelCommand::ReadRows(OpenXLSX::XLWorksheet& wks,
+                                const OpenXLSX::XLSharedStrings& shared_strings,
+                                const std::vector<int>& ranges,
+                                int first_row, int last_row,
+                                RowHandler&& on_row) {
+  if (Environments::GlobalEnvironment::GetInstance().GetReadMode() ==
+      Environments::ReadMode::STREAM) {
+    // One pass over <sheetData>: rows and cells are reached by sibling walk
+    SheetRowCursor cursor(wks, first_row, last_row, ranges[2], ranges[3]);
+    while (cursor.Next()) {
+      CellRow row;
+      row.first_col = ranges[2];
+      row.cells.reserve(ranges[3] - ranges[2] + 1);
+      for (auto& cell : cursor.Cells()) {
+        row.cells.push_back(GetCellValue(cell.value(), shared_strings, row));
+      }
+      on_row(std::move(row));
     }
-    std::vector<std::any> args{cell_string, col};
-    data_helper_->ExecuteData(sheet_name, key, sheet_type, args, context);
+    return;
+  }
+
+  for (int r = first_row; r <= last_row; r++) {
+    CellRow row;
+    row.first_col = ranges[2];
+    row.cells.reserve(ranges[3] - ranges[2] + 1);
+    for (int col = ranges[2]; col <= ranges[3]; col++) {
+      OpenXLSX::XLCellReference cell_ref(r, col);
+      row.cells.push_back(GetCellValue(wks.cell(cell_ref).value(), shared_strings, row));
+    }
+    on_row(std::move(row));
   }
 }
+
 void ReadExcelCommand::ExecuteSingleThread(OpenXLSX::XLWorksheet& wks,
+                                           const OpenXLSX::XLSharedStrings& shared_strings,
                                            const std::vector<int>& ranges,
-                                           const std::wstring& sheet_name,
-                                           const std::wstring& sheet_type) {
-  Logger::Log(L"Processing %d rows in single thread mode\n", ranges[1] - ranges[0] + 1);
+                                           Symbol sheet_name,
+                                           Symbol sheet_type,
+                                           std::any* context) {
+  LOG_INFO(L"Processing %d rows in single thread mode\n", ranges[1] - ranges[0] + 1);
+  DataHelper::Handle handle = data_helper_->Register(sheet_name, sheet_type);
 
-  for (int row = ranges[0]; row <= ranges[1]; row++) {
-    std::vector<std::pair<int, std::wstring>> row_cells;
-    for (int col = ranges[2]; col <= ranges[3]; col++) {
-      OpenXLSX::XLCellReference cell_ref(row, col);
-      OpenXLSX::XLCellValue cell_value = wks.cell(cell_ref).value();
-      std::wstring cell_string = get_cell_value(cell_value);
-      if (!cell_string.empty()) {
-        row_cells.emplace_back(col, std::move(cell_string));
-      }
-    }
-    ProcessRow(row_cells, sheet_name, sheet_type);
+  // Rows are handed to the processor in batches rather than cell by cell
+  std::vector<CellRow> batch;
+  batch.reserve(kRowBatchSize);
+  ReadRows(wks, shared_strings, ranges, ranges[0], ranges[1],
+           [&](CellRow&& row) {
+             batch.push_back(std::move(row));
+             if (batch.size() == kRowBatchSize) {
+               ProcessRows(batch, handle, context);
+               batch.clear();
+             }
+           });
+  if (!batch.empty()) {
+    ProcessRows(batch, handle, context);
   }
 }
 
 void ReadExcelCommand::ExecuteMultiThread(OpenXLSX::XLWorksheet& wks,
+                                          const OpenXLSX::XLSharedStrings& shared_strings,
                                           const std::vector<int>& ranges,
-                                          const std::wstring& sheet_name,
-                                          const std::wstring& sheet_type) {
+                                          Symbol sheet_name,
+                                          Symbol sheet_type,
+                                          std::any* context) {
   int row_count = ranges[1] - ranges[0] + 1;
 
   // 1. Prepare Processor
-  auto processor = data_helper_->GetOrRegisterProcessor(sheet_name, sheet_type);
+  DataHelper::Handle handle = data_helper_->Register(sheet_name, sheet_type);
+  auto processor = data_helper_->GetDataStructure(handle);
   if (!processor) {
-    Abort(L"Failed to get processor for %ls\n", sheet_name.c_str());
+    Abort(L"Failed to get processor for %ls\n", sheet_name.Name().c_str());
   }
 
-  std::vector<std::any> local_contexts;
+  // Each batch builds its own context, so merging them in batch order keeps row order
+  std::vector<std::any> batch_contexts((row_count + kRowBatchSize - 1) / kRowBatchSize);
+  size_t num_batches = 0;
 
   {
-    ThreadPool pool;
-    int num_workers = pool.GetNumWorkers();
-    Logger::Log(L"Processing %d rows in multi thread mode with %d workers\n", row_count, num_workers);
+    // Declared before the group so it outlives the tasks
+    BoundedQueue<RowBatch> queue(Environments::GlobalEnvironment::GetInstance().GetMaxInflightBatches());
 
-    local_contexts.resize(num_workers);
-    for (int i = 0; i < num_workers; ++i) {
-      local_contexts[i] = processor->CreateContext();
-    }
-
-    int rows_per_worker = row_count / num_workers;
-    int remainder = row_count % num_workers;
-    int current_row = ranges[0];
+    TaskGroup group;
+    int num_workers = group.Pool().GetNumWorkers();
+    LOG_INFO(L"Processing %d rows in multi thread mode with %d workers\n", row_count, num_workers);
 
+    // Workers start consuming as soon as the first batch is read
     for (int i = 0; i < num_workers; ++i) {
-      int start_row = current_row;
-      int count = rows_per_worker + (i < remainder ? 1 : 0);
-      int end_row = start_row + count - 1;
-      current_row += count;
-
-      if (count == 0) {
-        continue;
-      }
-
-      std::vector<std::vector<std::pair<int, std::wstring>>> chunk_data;
-      chunk_data.reserve(count);
-
-      for (int r = start_row; r <= end_row; ++r) {
-        std::vector<std::pair<int, std::wstring>> row_cells;
-        for (int col = ranges[2]; col <= ranges[3]; col++) {
-          OpenXLSX::XLCellReference cell_ref(r, col);
-          OpenXLSX::XLCellValue cell_value = wks.cell(cell_ref).value();
-          std::wstring cell_string = get_cell_value(cell_value);
-          if (!cell_string.empty()) {
-            row_cells.emplace_back(col, std::move(cell_string));
-          }
-        }
-        chunk_data.push_back(std::move(row_cells));
-      }
-
-      std::any* ctx_ptr = &local_contexts[i];
-
-      pool.EnqueueTask([this, data = std::move(chunk_data), sheet_name, sheet_type, ctx_ptr]() {
-        for (const auto& row : data) {
-          ProcessRow(row, sheet_name, sheet_type, ctx_ptr);
+      group.Run([this, &queue, &batch_contexts, &processor, handle]() {
+        RowBatch batch;
+        while (queue.Pop(batch)) {
+          std::any& context = batch_contexts[batch.index];
+          context = processor->CreateContext();
+          ProcessRows(batch.rows, handle, &context);
         }
       });
     }
-  }  // Pool destroyed, waits for all tasks.
 
-  // 2. Merge Results
-  data_helper_->MergeContexts(sheet_name, local_contexts);
+    RowBatch batch;
+    batch.rows.reserve(kRowBatchSize);
+    ReadRows(wks, shared_strings, ranges, ranges[0], ranges[1],
+             [&](CellRow&& row) {
+               batch.rows.push_back(std::move(row));
+               if (batch.rows.size() == kRowBatchSize) {
+                 batch.index = num_batches++;
+                 queue.Push(std::move(batch));
+                 batch = RowBatch();
+                 batch.rows.reserve(kRowBatchSize);
+               }
+             });
+    if (!batch.rows.empty()) {
+      batch.index = num_batches++;
+      queue.Push(std::move(batch));
+    }
+    queue.Close();
+    group.Wait();
+  }
+
+  // 2. Merge Results (stream mode skips missing rows, so fewer batches may exist)
+  batch_contexts.resize(num_batches);
+  if (!context) {
+    data_helper_->MergeContexts(handle, std::move(batch_contexts));
+  } else if (num_batches > 0) {
+    *context = DataHelper::ReduceContexts(*processor, std::move(batch_contexts));
+  }
 }
 
 void ReadExcelCommand::ExecuteCuda(OpenXLSX::XLWorksheet& wks,
+                                   const OpenXLSX::XLSharedStrings& shared_strings,
                                    const std::vector<int>& ranges,
-                                   const std::wstring& sheet_name,
-                                   const std::wstring& sheet_type) {
-  Logger::Log(L"Processing %d rows in CUDA mode\n",
-              ranges[1] - ranges[0] + 1);
+                                   Symbol sheet_name,
+                                   Symbol sheet_type,
+                                   std::any* context) {
+  LOG_INFO(L"Processing %d rows in CUDA mode\n",
+           ranges[1] - ranges[0] + 1);
 
 #ifdef CUDA_ENABLED
   // Check CUDA availability
   if (!CudaProcessor::IsCudaAvailable()) {
-    Logger::Log(L"CUDA is not available, falling back to multi thread mode\n");
-    ExecuteMultiThread(wks, ranges, sheet_name, sheet_type);
+    LOG_WARN(L"CUDA is not available, falling back to multi thread mode\n");
+    ExecuteMultiThread(wks, shared_strings, ranges, sheet_name, sheet_type, context);
     return;
   }
 
@@ -156,77 +206,156 @@ void ReadExcelCommand::ExecuteCuda(OpenXLSX::XLWorksheet& wks,
   CudaProcessor::PrintCudaDeviceInfo();
 
   // Read all row data into memory first
-  std::vector<std::vector<std::pair<int, std::wstring>>> all_row_data;
+  std::vector<CellRow> all_row_data;
   all_row_data.reserve(ranges[1] - ranges[0] + 1);
 
-  for (int row = ranges[0]; row <= ranges[1]; row++) {
-    std::vector<std::pair<int, std::wstring>> row_cells;
-    for (int col = ranges[2]; col <= ranges[3]; col++) {
-      OpenXLSX::XLCellReference cell_ref(row, col);
-      OpenXLSX::XLCellValue cell_value = wks.cell(cell_ref).value();
-      std::wstring cell_string = get_cell_value(cell_value);
-      if (!cell_string.empty()) {
-        row_cells.emplace_back(col, std::move(cell_string));
-      }
-    }
-    all_row_data.push_back(std::move(row_cells));
-  }
+  ReadRows(wks, shared_strings, ranges, ranges[0], ranges[1],
+           [&](CellRow&& row) {
+             all_row_data.push_back(std::move(row));
+           });
 
   // Process data with CUDA
   bool cuda_success = CudaProcessor::ProcessRowsWithCuda(all_row_data);
 
   if (!cuda_success) {
-    Logger::Log(L"CUDA processing failed, falling back to single thread mode\n");
-    ExecuteSingleThread(wks, ranges, sheet_name, sheet_type);
+    LOG_WARN(L"CUDA processing failed, falling back to single thread mode\n");
+    ExecuteSingleThread(wks, shared_strings, ranges, sheet_name, sheet_type, context);
     return;
   }
 
-  // Pass results to ProcessRow after CUDA processing
-  for (const auto& row_cells : all_row_data) {
-    ProcessRow(row_cells, sheet_name, sheet_type);
-  }
+  // Pass results to ProcessRows after CUDA processing
+  ProcessRows(all_row_data, data_helper_->Register(sheet_name, sheet_type), context);
 
-  Logger::Log(L"CUDA processing completed successfully\n");
+  LOG_INFO(L"CUDA processing completed successfully\n");
 #else
   // Fall back to multi-thread mode when CUDA is disabled
-  Logger::Log(L"CUDA is not enabled in this build, falling back to multi thread mode\n");
-  ExecuteMultiThread(wks, ranges, sheet_name, sheet_type);
+  LOG_INFO(L"CUDA is not enabled in this build, falling back to multi thread mode\n");
+  ExecuteMultiThread(wks, shared_strings, ranges, sheet_name, sheet_type, context);
 #endif
 }
 
+void ReadExcelCommand::ExecuteSheetsParallel(OpenXLSX::XLDocument& doc,
+                                             const std::vector<SheetSpec>& sheets) {
+  // Specs naming the same sheet share its XML and its registry entry, so they
+  // are read by one task, in spec order
+  std::vector<std::vector<const SheetSpec*>> groups;
+  std::unordered_map<Symbol, size_t> group_of;
+  for (const auto& sheet : sheets) {
+    auto [it, inserted] = group_of.try_emplace(sheet.name, groups.size());
+    if (inserted) {
+      groups.emplace_back();
+    }
+    groups[it->second].push_back(&sheet);
+  }
+  LOG_INFO(L"Reading %zu sheets in parallel\n", groups.size());
+
+  // Sheets are claimed one at a time, so a large sheet does not hold up the rest
+  ParallelFor(IndexRange{0, groups.size()}, 1, [this, &doc, &groups](IndexRange part) {
+    for (size_t i = part.begin; i < part.end; ++i) {
+      Symbol sheet_name = groups[i].front()->name;
+      // The sheet XML is loaded and parsed here, so sheets are parsed concurrently
+      auto wks = doc.workbook().worksheet(Cts(sheet_name.Name()));
+      for (const SheetSpec* sheet : groups[i]) {
+        auto processor = data_helper_->GetOrRegisterProcessor(sheet->name, sheet->type);
+        if (!processor) {
+          Abort(L"Failed to get processor for %ls\n", sheet->name.Name().c_str());
+        }
+
+        // Build into a private context and publish it once the range is done
+        std::any context = processor->CreateContext();
+        ExecuteSingleThread(wks, doc.sharedStrings(), sheet->ranges, sheet->name, sheet->type, &context);
+        if (!sheet->snapshot_key.empty()) {
+          data_helper_->SaveSnapshot(sheet->name, sheet->type, sheet->snapshot_key, context);
+        }
+        data_helper_->CommitContext(sheet->name, sheet->type, std::move(context));
+      }
+    }
+  });
+
+  for (const auto& group : groups) {
+    data_helper_->PrintData(group.front()->name);
+  }
+}
+
 void ReadExcelCommand::Execute(const YAML::Node& command_data) {
   OpenXLSX::XLDocument doc;
   std::string excel_name = command_data["name"].as<std::string>();
-  Logger::Log(L"Read %ls\n", Ctw(excel_name).c_str());
-  doc.open(excel_name);
+  LOG_INFO(L"Read %ls\n", Ctw(excel_name).c_str());
+
+  // Sheets with a valid snapshot are loaded from the cache instead of the workbook
+  uint64_t content_hash = 0;
+  bool use_snapshots = !Environments::GlobalEnvironment::GetInstance().GetSnapshotDir().empty() &&
+                       Snapshot::HashFile(excel_name, content_hash);
 
+  std::vector<SheetSpec> sheets;
   for (const auto& sheet : command_data["sheets"]) {
     std::wstring sheet_name = Ctw(sheet["name"].as<std::string>()),
                  range = Ctw(sheet["range"].as<std::string>()),
                  sheet_type = Ctw(sheet["type"].as<std::string>());
-    std::vector<int> ranges;
-    Logger::Log(L"sheet name : %ls type : %ls\n", sheet_name.c_str(),
-                sheet_type.c_str());
-    ranges = ExcelUtils::ParseExcelRange(range);
-    auto wks = doc.workbook().worksheet(Cts(sheet_name));
+    LOG_INFO(L"sheet name : %ls type : %ls\n", sheet_name.c_str(),
+             sheet_type.c_str());
+    SheetSpec spec{SymbolTable::Intern(sheet_name), SymbolTable::Intern(sheet_type), range,
+                   ExcelUtils::ParseExcelRange(range), ""};
+    if (use_snapshots) {
+      spec.snapshot_key = Snapshot::Key(content_hash, sheet_name, sheet_type, range);
+      if (data_helper_->LoadSnapshot(spec.name, spec.type, spec.snapshot_key)) {
+        data_helper_->PrintData(spec.name);
+        continue;
+      }
+    }
+    sheets.push_back(std::move(spec));
+  }
+
+  // The workbook is only unzipped and parsed if some sheet has to be read
+  if (!sheets.empty()) {
+    doc.open(excel_name);
+
+    // Sheets are independent of each other; optionally read them all at once
+    if (command_data["parallel_sheets"] && command_data["parallel_sheets"].as<bool>()) {
+      ExecuteSheetsParallel(doc, sheets);
+    } else {
+      ExecuteSheetsSequential(doc, sheets);
+    }
+  }
+
+  // Do expense output construction after reading excel is finished.
+  std::wstring key = L"";
+  data_helper_->ExecuteData(Symbols::kExpenseOutput, key, Symbols::kExpenseOutput, {}, nullptr);
+}
+
+void ReadExcelCommand::ExecuteSheetsSequential(OpenXLSX::XLDocument& doc,
+                                               const std::vector<SheetSpec>& sheets) {
+  for (const auto& sheet : sheets) {
+    Symbol sheet_name = sheet.name;
+    Symbol sheet_type = sheet.type;
+    const std::vector<int>& ranges = sheet.ranges;
+    auto wks = doc.workbook().worksheet(Cts(sheet_name.Name()));
+    auto processor = data_helper_->GetOrRegisterProcessor(sheet_name, sheet_type);
+    if (!processor) {
+      Abort(L"Failed to get processor for %ls\n", sheet_name.Name().c_str());
+    }
+
+    // Built privately, so the snapshot holds only this spec's rows
+    std::any context = processor->CreateContext();
 
     // Use different processing method depending on execution mode
     Environments::ExecutionMode core_type = Environments::GlobalEnvironment::GetInstance().GetCoreType();
     std::cout << "Current Execution Mode: " << static_cast<int>(core_type) << std::endl;
     switch (core_type) {
       case Environments::ExecutionMode::SINGLE_THREAD:
-        ExecuteSingleThread(wks, ranges, sheet_name, sheet_type);
+        ExecuteSingleThread(wks, doc.sharedStrings(), ranges, sheet_name, sheet_type, &context);
         break;
       case Environments::ExecutionMode::MULTI_THREAD:
-        ExecuteMultiThread(wks, ranges, sheet_name, sheet_type);
+        ExecuteMultiThread(wks, doc.sharedStrings(), ranges, sheet_name, sheet_type, &context);
         break;
       case Environments::ExecutionMode::CUDA:
-        ExecuteCuda(wks, ranges, sheet_name, sheet_type);
+        ExecuteCuda(wks, doc.sharedStrings(), ranges, sheet_name, sheet_type, &context);
         break;
     }
+    if (!sheet.snapshot_key.empty()) {
+      data_helper_->SaveSnapshot(sheet_name, sheet_type, sheet.snapshot_key, context);
+    }
+    data_helper_->CommitContext(sheet_name, sheet_type, std::move(context));
     data_helper_->PrintData(sheet_name);
   }
-  // Do expense output construction after reading excel is finished.
-  std::wstring key = L"";
-  data_helper_->ExecuteData(L"ExpenseOutput", key, L"ExpenseOutput", {}, nullptr);
 }
@@ -16,12 +16,14 @@
 #include <yaml-cpp/yaml.h>
 
 #include <OpenXLSX.hpp>
+#include <any>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "CommandProcessor/command_processor.h"
+#include "DataProcessor/cell_value.h"
 
 class ReadExcelCommand : public BaseCommand {
  public:
@@ -30,28 +32,74 @@ class ReadExcelCommand : public BaseCommand {
 
   void Execute(const YAML::Node& command_data) override;
 
-  std::wstring get_cell_value(const OpenXLSX::XLCellValue& cell_value);
+  // Typed value of a cell. Shared strings are returned as views into the
+  // shared-string cache; other strings are stored in row.owned_strings.
+  CellValue GetCellValue(const OpenXLSX::XLCellValueProxy& cell_value,
+                         const OpenXLSX::XLSharedStrings& shared_strings,
+                         CellRow& row);
 
  private:
-  // cells: vector of (column, cell_value)
-  void ProcessRow(const std::vector<std::pair<int, std::wstring>>& cells,
-                  const std::wstring& sheet_name,
-                  const std::wstring& sheet_type,
-                  std::any* context = nullptr);
+  // One entry of the command's "sheets" list.
+  struct SheetSpec {
+    Symbol name;
+    Symbol type;
+    std::wstring range;
+    std::vector<int> ranges;
+    std::string snapshot_key;  // empty when the snapshot cache is off
+  };
+
+  // Reads the sheets one after another with the configured execution mode.
+  // Each spec is built into a private context, saved as its snapshot and
+  // then committed to the DataHelper registry.
+  void ExecuteSheetsSequential(OpenXLSX::XLDocument& doc,
+                               const std::vector<SheetSpec>& sheets);
+
+  // Reads every sheet on its own worker (parallel_sheets: true). Each worker
+  // parses its sheet XML, then builds a private context per spec of that
+  // sheet and commits them to the DataHelper registry in spec order.
+  void ExecuteSheetsParallel(OpenXLSX::XLDocument& doc,
+                             const std::vector<SheetSpec>& sheets);
+
+  // Rows handed to the processor at a time.
+  static constexpr size_t kRowBatchSize = 1024;
+
+  // Unit of work between the reader and the multi thread workers.
+  struct RowBatch {
+    size_t index = 0;  // position of the batch within the sheet
+    std::vector<CellRow> rows;
+  };
+
+  void ProcessRows(const CellRowSpan& rows,
+                   DataHelper::Handle handle,
+                   std::any* context = nullptr);
+
+  // Reads rows [first_row, last_row] within the column span of ranges and
+  // hands each row's cells to on_row, using the configured read mode.
+  template <typename RowHandler>
+  void ReadRows(OpenXLSX::XLWorksheet& wks,
+                const OpenXLSX::XLSharedStrings& shared_strings,
+                const std::vector<int>& ranges,
+                int first_row, int last_row, RowHandler&& on_row);
 
   void ExecuteSingleThread(OpenXLSX::XLWorksheet& wks,
+                           const OpenXLSX::XLSharedStrings& shared_strings,
                            const std::vector<int>& ranges,
-                           const std::wstring& sheet_name,
-                           const std::wstring& sheet_type);
+                           Symbol sheet_name,
+                           Symbol sheet_type,
+                           std::any* context = nullptr);
 
   void ExecuteMultiThread(OpenXLSX::XLWorksheet& wks,
+                          const OpenXLSX::XLSharedStrings& shared_strings,
                           const std::vector<int>& ranges,
-                          const std::wstring& sheet_name,
-                          const std::wstring& sheet_type);
+                          Symbol sheet_name,
+                          Symbol sheet_type,
+                          std::any* context = nullptr);
 
   void ExecuteCuda(OpenXLSX::XLWorksheet& wks,
+                   const OpenXLSX::XLSharedStrings& shared_strings,
                    const std::vector<int>& ranges,
-                   const std::wstring& sheet_name,
-                   const std::wstring& sheet_type);
+                   Symbol sheet_name,
+                   Symbol sheet_type,
+                   std::any* context = nullptr);
 };
 #endif  // SRC_COMMANDPROCESSOR_READ_EXCEL_H_
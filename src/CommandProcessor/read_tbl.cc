@@ -13,26 +13,108 @@
 // ============================================================================
 #include "CommandProcessor/read_tbl.h"
 
-#include <fstream>
+#include <algorithm>
+#include <any>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "DataProcessor/snapshot.h"
+#include "DataProcessor/tbl_data_structure.h"
+#include "Environments/global_environment.h"
 #include "Logger/logger.h"
 #include "Utility/abort.h"
+#include "Utility/mapped_file.h"
+#include "Utility/parallel.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
+#include "Utility/tbl_scanner.h"
+
+namespace {
+// Chunks smaller than this are not worth a task of their own.
+constexpr size_t kMinChunkBytes = 1 << 20;
+
+// Chunks per worker, for load balancing between them.
+constexpr size_t kChunksPerWorker = 4;
+
+// Splits text into at most parts pieces, each ending right after a newline
+// (or at the end of the text), so no line straddles two pieces.
+std::vector<std::string_view> SplitAtLines(std::string_view text, size_t parts) {
+  std::vector<std::string_view> chunks;
+  size_t chunk_size = std::max(text.size() / std::max<size_t>(parts, 1), kMinChunkBytes);
+  size_t begin = 0;
+  while (begin < text.size()) {
+    size_t end = begin + chunk_size;
+    if (end >= text.size()) {
+      end = text.size();
+    } else {
+      auto newline = static_cast<const char*>(std::memchr(text.data() + end, '\n', text.size() - end));
+      end = newline ? static_cast<size_t>(newline - text.data()) + 1 : text.size();
+    }
+    chunks.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+}  // namespace
+
 void ReadTblCommand::Execute(const YAML::Node &command_data) {
   std::string file_name = command_data["name"].as<std::string>();
-  Logger::Log(L"Read %ls\n", Ctw(file_name).c_str());
-  std::ifstream tbl_file(file_name);
-  if (!tbl_file) {
+  LOG_INFO(L"Read %ls\n", Ctw(file_name).c_str());
+  MappedFile tbl_file(file_name);
+  if (!tbl_file.IsOpen()) {
     Abort(L"Failed to open file %ls\n", Ctw(file_name).c_str());
   }
-  std::string line{};
   std::wstring key{Ctw(file_name)};
-  while (std::getline(tbl_file, line)) {
-    std::vector<std::any> args{Ctw(line)};
-    data_helper_->ExecuteData(Ctw(file_name), key, L"Table", args);
+  Symbol key_symbol = SymbolTable::Intern(key);
+
+  // A snapshot of the same file content replaces parsing altogether
+  std::string snapshot_key;
+  if (!Environments::GlobalEnvironment::GetInstance().GetSnapshotDir().empty()) {
+    snapshot_key = Snapshot::Key(Snapshot::Hash(tbl_file.View()), key, L"Table", L"");
+    if (data_helper_->LoadSnapshot(key_symbol, Symbols::kTable, snapshot_key)) {
+      data_helper_->PrintData(key_symbol);
+      return;
+    }
+  }
+
+  // Lines are parsed in place, in parallel chunks split at line boundaries.
+  // Workers take several chunks each, so dense chunks do not hold up the rest.
+  ThreadPool *pool = DataHelper::WorkerPool();
+  size_t parts = pool ? pool->GetNumWorkers() * kChunksPerWorker : 1;
+  std::vector<std::string_view> chunks = SplitAtLines(tbl_file.View(), parts);
+  std::vector<TableData> chunk_rows(chunks.size());
+  ParallelFor(
+      IndexRange{0, chunks.size()}, 1,
+      [&chunks, &chunk_rows](IndexRange part) {
+        for (size_t i = part.begin; i < part.end; ++i) {
+          TableDataStructure::ParseRows(chunks[i], chunk_rows[i]);
+        }
+      },
+      pool);
+
+  // Stitch the chunks back together in file order
+  TableDataStructure::TableDataMap table;
+  auto &rows = table[key];
+  size_t row_count = 0;
+  size_t value_count = 0;
+  for (const auto &chunk : chunk_rows) {
+    row_count += chunk.size();
+    value_count += chunk.ValueCount();
+  }
+  rows.Reserve(row_count, value_count);
+  for (auto &chunk : chunk_rows) {
+    rows.Append(std::move(chunk));
+  }
+  LOG_INFO(L"Parsed %zu rows in %zu chunks (%ls)\n", row_count, chunks.size(),
+           TblScanner::SimdLevelName(TblScanner::DetectSimdLevel()));
+
+  std::any context = std::move(table);
+  if (!snapshot_key.empty()) {
+    data_helper_->SaveSnapshot(key_symbol, Symbols::kTable, snapshot_key, context);
   }
-  tbl_file.close();
-  data_helper_->PrintData(Ctw(file_name));
+  data_helper_->CommitContext(key_symbol, Symbols::kTable, std::move(context));
+  data_helper_->PrintData(key_symbol);
 }
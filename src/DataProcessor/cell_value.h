@@ -0,0 +1,138 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_CELL_VALUE_H_
+#define SRC_DATAPROCESSOR_CELL_VALUE_H_
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "Utility/string_utils.h"
+
+// Typed value of a single worksheet cell.
+// Strings are views into storage owned elsewhere (the workbook's shared-string
+// cache, or the CellRow carrying the cell), so a CellValue never allocates.
+class CellValue {
+ public:
+  CellValue() = default;
+  explicit CellValue(int64_t value) : value_(value) {}
+  explicit CellValue(double value) : value_(value) {}
+  explicit CellValue(std::string_view value) : value_(value) {}
+
+  bool IsEmpty() const {
+    if (std::holds_alternative<std::monostate>(value_)) {
+      return true;
+    }
+    auto text = std::get_if<std::string_view>(&value_);
+    return text && text->empty();
+  }
+  bool IsString() const { return std::holds_alternative<std::string_view>(value_); }
+
+  // Floats are truncated, strings are parsed like std::stoll.
+  int64_t AsInt() const {
+    if (auto value = std::get_if<int64_t>(&value_)) {
+      return *value;
+    }
+    if (auto value = std::get_if<double>(&value_)) {
+      return static_cast<int64_t>(*value);
+    }
+    if (auto text = std::get_if<std::string_view>(&value_)) {
+      return std::strtoll(std::string(*text).c_str(), nullptr, 10);
+    }
+    return 0;
+  }
+
+  double AsDouble() const {
+    if (auto value = std::get_if<double>(&value_)) {
+      return *value;
+    }
+    if (auto value = std::get_if<int64_t>(&value_)) {
+      return static_cast<double>(*value);
+    }
+    if (auto text = std::get_if<std::string_view>(&value_)) {
+      return std::strtod(std::string(*text).c_str(), nullptr);
+    }
+    return 0.0;
+  }
+
+  // Empty view for non-string cells.
+  std::string_view AsString() const {
+    if (auto text = std::get_if<std::string_view>(&value_)) {
+      return *text;
+    }
+    return {};
+  }
+
+  // Only for fields that are stored as text (names, qx table keys).
+  std::wstring ToWString() const {
+    if (auto text = std::get_if<std::string_view>(&value_)) {
+      return StringUtils::CharToWide(*text);
+    }
+    if (auto value = std::get_if<int64_t>(&value_)) {
+      return std::to_wstring(*value);
+    }
+    if (auto value = std::get_if<double>(&value_)) {
+      return std::to_wstring(*value);
+    }
+    return L"";
+  }
+
+ private:
+  std::variant<std::monostate, int64_t, double, std::string_view> value_;
+};
+
+// Contiguous, column-indexed row of typed cells: cells[i] holds column
+// first_col + i. Empty cells are kept so a column lookup is a plain index.
+struct CellRow {
+  int first_col = 1;
+  std::vector<CellValue> cells;
+  // Backing storage for strings that are not in the shared-string cache
+  // (inline strings, formula results). Heap-held so moving the row keeps views valid.
+  std::vector<std::unique_ptr<std::string>> owned_strings;
+
+  int LastColumn() const { return first_col + static_cast<int>(cells.size()) - 1; }
+
+  // Empty value for columns outside the row.
+  const CellValue& Cell(int col) const {
+    static const CellValue kEmpty;
+    if (col < first_col || col > LastColumn()) {
+      return kEmpty;
+    }
+    return cells[col - first_col];
+  }
+};
+
+// Non-owning view over a batch of consecutive rows.
+class CellRowSpan {
+ public:
+  CellRowSpan(const CellRow* rows, size_t size) : rows_(rows), size_(size) {}
+  CellRowSpan(const std::vector<CellRow>& rows)  // NOLINT(runtime/explicit)
+      : rows_(rows.data()), size_(rows.size()) {}
+
+  const CellRow* begin() const { return rows_; }
+  const CellRow* end() const { return rows_ + size_; }
+  size_t size() const { return size_; }
+  const CellRow& operator[](size_t i) const { return rows_[i]; }
+
+ private:
+  const CellRow* rows_;
+  size_t size_;
+};
+
+#endif  // SRC_DATAPROCESSOR_CELL_VALUE_H_
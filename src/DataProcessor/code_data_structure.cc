@@ -16,57 +16,81 @@
 #include <any>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
+#include "DataProcessor/data_helper.h"
 #include "DataProcessor/excel_columns.h"
 #include "Logger/logger.h"
 void CodeDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   auto& code_context = std::any_cast<CodeDataContext&>(context);
-  std::wstring input = std::any_cast<std::wstring>(args[0]);
+  const auto& input = std::any_cast<const CellValue&>(args[0]);
   int column = std::any_cast<int>(args[1]);
-  int key_to_int = 0;
-  auto toInt = [](const std::wstring& str) -> int { return std::stoi(str); };
-  auto toDouble = [](const std::wstring& str) -> float {
-    return std::stod(str);
-  };
   if (column == CodeColumns::FIRST_COLUMN) {
-    key = input;
-    key_to_int = toInt(key);
-    code_context.code_table[key_to_int] = std::make_shared<CodeTable>();
+    key = input.ToWString();
+    code_context.code_table[static_cast<int>(input.AsInt())] = GetDataHelper()->ContextArena().MakeShared<CodeTable>();
     return;
   }
-  key_to_int = toInt(key);
-  auto current_code_table = code_context.code_table[key_to_int].get();
+  SetField(code_context, *code_context.code_table[std::stoi(key)], column, input);
+}
+
+void CodeDataStructure::ConstructFromRows(std::any& context, const CellRowSpan& rows, const std::wstring& /*key*/) {
+  auto& code_context = std::any_cast<CodeDataContext&>(context);
+  BumpArena& arena = GetDataHelper()->ContextArena();
+  for (const auto& row : rows) {
+    const CellValue& key_cell = row.Cell(CodeColumns::FIRST_COLUMN);
+    if (key_cell.IsEmpty()) {
+      continue;
+    }
+    auto current_code_table = arena.MakeShared<CodeTable>();
+    code_context.code_table[static_cast<int>(key_cell.AsInt())] = current_code_table;
+    for (int column = CodeColumns::FIRST_COLUMN + 1; column <= row.LastColumn(); ++column) {
+      const CellValue& input = row.Cell(column);
+      if (!input.IsEmpty()) {
+        SetField(code_context, *current_code_table, column, input);
+      }
+    }
+  }
+}
+
+void CodeDataStructure::SetField(CodeDataContext& code_context, CodeTable& current_code_table, int column, const CellValue& input) {
+  auto toInt = [](const CellValue& value) -> int { return static_cast<int>(value.AsInt()); };
+  // qx_table_ stores float
+  auto toFloat = [](const CellValue& value) -> float {
+    return static_cast<float>(value.AsDouble());
+  };
   switch (column) {
     case CodeColumns::FIRST_COLUMN:
       break;
     case CodeColumns::DNUM:
-      current_code_table->dnum = toInt(input);
+      current_code_table.dnum = toInt(input);
       break;
     case CodeColumns::NAME:
-      current_code_table->name = input;
+      current_code_table.name = input.ToWString();
       break;
     case CodeColumns::QX_KU:
-      current_code_table->qx_ku = toInt(input);
+      current_code_table.qx_ku = toInt(input);
       break;
     case CodeColumns::MHJ:
-      current_code_table->mhj = toInt(input);
+      current_code_table.mhj = toInt(input);
       break;
     case CodeColumns::RE:
-      current_code_table->re = toInt(input);
+      current_code_table.re = toInt(input);
       break;
     case CodeColumns::M_COUNT:
-      current_code_table->M_count = toInt(input);
+      current_code_table.M_count = toInt(input);
       break;
     default:
       if (column > CodeColumns::QX_TABLE_START && column <= CodeColumns::QX_TABLE_END) {
-        current_code_table->qx_table_[input];  // default-construct entry
-        code_context.table_for_qx_table[code_context.current_index_of_qx_table++] = input;
+        std::wstring qx_name = input.ToWString();
+        current_code_table.qx_table_[qx_name];  // default-construct entry
+        code_context.table_for_qx_table[code_context.current_index_of_qx_table++] = qx_name;
       } else if (column >= CodeColumns::QX_VALUES_START) {
         int qx_index = (column - CodeColumns::QX_VALUES_START) / 3;
         if (qx_index < code_context.current_index_of_qx_table) {
           const std::wstring& qx_name = code_context.table_for_qx_table[qx_index];
-          current_code_table->qx_table_[qx_name].emplace_back(toDouble(input));
+          current_code_table.qx_table_[qx_name].emplace_back(toFloat(input));
         }
       }
       break;
@@ -82,29 +106,113 @@ void CodeDataStructure::MergeDataStructure(std::any& target, const std::any& sou
   }
 }
 
+void CodeDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  auto& target_table = std::any_cast<CodeDataContext&>(target).code_table;
+  auto& source_table = std::any_cast<CodeDataContext&>(source).code_table;
+  if (target_table.empty()) {
+    target_table = std::move(source_table);
+    return;
+  }
+  // Map nodes move across as they are; a key already present takes source's record
+  while (!source_table.empty()) {
+    auto node = source_table.extract(source_table.begin());
+    auto it = target_table.find(node.key());
+    if (it != target_table.end()) {
+      it->second = std::move(node.mapped());
+    } else {
+      target_table.insert(std::move(node));
+    }
+  }
+}
+
 void CodeDataStructure::PrintDataStructure(const std::any& context) const {
   const auto& code_context = std::any_cast<const CodeDataContext&>(context);
   for (const auto& entry : code_context.code_table) {
     int code_index = entry.first;
     auto current_code_table = entry.second.get();
 
-    Logger::Log(L"Code Index: %d\n", code_index);
-    Logger::Log(L"  dnum: %d\n", current_code_table->dnum);
-    Logger::Log(L"  name: %ls\n", current_code_table->name.c_str());
-    Logger::Log(L"  qx_ku: %d\n", current_code_table->qx_ku);
-    Logger::Log(L"  mhj: %d\n", current_code_table->mhj);
-    Logger::Log(L"  re: %d\n", current_code_table->re);
-    Logger::Log(L"  M_count: %d\n", current_code_table->M_count);
+    LOG_DEBUG(L"Code Index: %d\n", code_index);
+    LOG_DEBUG(L"  dnum: %d\n", current_code_table->dnum);
+    LOG_DEBUG(L"  name: %ls\n", current_code_table->name.c_str());
+    LOG_DEBUG(L"  qx_ku: %d\n", current_code_table->qx_ku);
+    LOG_DEBUG(L"  mhj: %d\n", current_code_table->mhj);
+    LOG_DEBUG(L"  re: %d\n", current_code_table->re);
+    LOG_DEBUG(L"  M_count: %d\n", current_code_table->M_count);
 
     // qx_table
-    Logger::Log(L"  qx_table:\n");
+    LOG_DEBUG(L"  qx_table:\n");
     for (const auto& qx_entry : current_code_table->qx_table_) {
-      Logger::Log(L"    %ls: ", qx_entry.first.c_str());
+      LOG_DEBUG(L"    %ls: ", qx_entry.first.c_str());
       for (const float value : qx_entry.second) {
-        Logger::Log(L"%.2f ", value);
+        LOG_DEBUG(L"%.2f ", value);
       }
-      Logger::Log(L"\n");
+      LOG_DEBUG(L"\n");
+    }
+    LOG_DEBUG(L"-----------------------------------\n");
+  }
+}
+
+bool CodeDataStructure::SaveContext(const std::any& context, SnapshotWriter& out) const {
+  const auto& code_context = std::any_cast<const CodeDataContext&>(context);
+  out.Put<uint64_t>(code_context.code_table.size());
+  for (const auto& [code, table] : code_context.code_table) {
+    if (!table) {
+      return false;
+    }
+    out.Put(code);
+    out.Put(table->dnum);
+    out.PutString(table->name);
+    out.Put(table->qx_ku);
+    out.Put(table->mhj);
+    out.Put(table->re);
+    out.Put(table->M_count);
+    out.Put<uint64_t>(table->qx_table_.size());
+    for (const auto& [qx_key, rates] : table->qx_table_) {
+      out.PutString(qx_key);
+      out.PutVector(rates);
+    }
+  }
+  out.Put(code_context.current_index_of_qx_table);
+  out.Put<uint64_t>(code_context.table_for_qx_table.size());
+  for (const auto& [index, name] : code_context.table_for_qx_table) {
+    out.Put(index);
+    out.PutString(name);
+  }
+  return true;
+}
+
+bool CodeDataStructure::LoadContext(SnapshotReader& in, std::any& context) const {
+  BumpArena& arena = GetDataHelper()->ContextArena();
+  auto& code_context = std::any_cast<CodeDataContext&>(context);
+  uint64_t count = 0;
+  if (!in.GetCount(count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    int code = 0;
+    auto table = arena.MakeShared<CodeTable>();
+    uint64_t qx_count = 0;
+    if (!in.Get(code) || !in.Get(table->dnum) || !in.GetString(table->name) || !in.Get(table->qx_ku) ||
+        !in.Get(table->mhj) || !in.Get(table->re) || !in.Get(table->M_count) || !in.GetCount(qx_count)) {
+      return false;
+    }
+    for (uint64_t j = 0; j < qx_count; ++j) {
+      std::wstring qx_key;
+      if (!in.GetString(qx_key) || !in.GetVector(table->qx_table_[qx_key])) {
+        return false;
+      }
+    }
+    code_context.code_table[code] = std::move(table);
+  }
+  uint64_t name_count = 0;
+  if (!in.Get(code_context.current_index_of_qx_table) || !in.GetCount(name_count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < name_count; ++i) {
+    int index = 0;
+    if (!in.Get(index) || !in.GetString(code_context.table_for_qx_table[index])) {
+      return false;
     }
-    Logger::Log(L"-----------------------------------\n");
   }
+  return true;
 }
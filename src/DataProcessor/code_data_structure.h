@@ -42,9 +42,18 @@ class CodeDataStructure : public IDataStructure {
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
   std::any CreateContext() const override { return CodeDataContext(); }
+  bool SaveContext(const std::any& context, SnapshotWriter& out) const override;
+  bool LoadContext(SnapshotReader& in, std::any& context) const override;
+
+ private:
+  static void SetField(CodeDataContext& code_context, CodeTable& current_code_table,
+                       int column, const CellValue& input);
 };
 
 #endif  // SRC_DATAPROCESSOR_CODE_DATA_STRUCTURE_H_
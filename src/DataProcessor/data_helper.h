@@ -13,235 +13,319 @@
 // ============================================================================
 #ifndef SRC_DATAPROCESSOR_DATA_HELPER_H_
 #define SRC_DATAPROCESSOR_DATA_HELPER_H_
+#include <algorithm>
 #include <any>
-#include <atomic>
+#include <array>
 #include <filesystem>
+#include <fstream>
 #include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "DataProcessor/code_data_structure.h"
 #include "DataProcessor/data_processor.h"
+#include "DataProcessor/data_registry.h"
 #include "DataProcessor/expense_data_structure.h"
 #include "DataProcessor/expense_output_data_structure.h"
 #include "DataProcessor/insurance_output_data_structure.h"
 #include "DataProcessor/insurance_result_data_structure.h"
 #include "DataProcessor/qx_data_structure.h"
+#include "DataProcessor/snapshot.h"
 #include "DataProcessor/sratio_data_structure.h"
 #include "DataProcessor/tbl_data_structure.h"
 #include "DataProcessor/termination_data_structure.h"
+#include "Environments/global_environment.h"
 #include "Logger/logger.h"
+#include "Utility/arena.h"
+#include "Utility/mapped_file.h"
+#include "Utility/parallel.h"
+#include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
+#include "Utility/thread_pool.h"
 
 class DataHelper : public std::enable_shared_from_this<DataHelper> {
-  struct Registry {
-    std::unordered_map<std::wstring, std::shared_ptr<IDataStructure>> processors;
-    std::unordered_map<std::wstring, std::any> contexts;
-    std::unordered_map<std::wstring, std::shared_ptr<IDataStructure>> type_cache;
-  };
-
  public:
-  DataHelper() {
-    std::atomic_store(&registry_, std::make_shared<Registry>());
-  }
+  // Registered name; resolve once with Register, then pass to the
+  // handle overloads to skip the name lookup.
+  using Handle = DataRegistry::Handle;
+  static constexpr Handle kInvalidHandle = DataRegistry::kInvalidHandle;
+
+  DataHelper() = default;
   ~DataHelper() = default;
 
-  std::shared_ptr<IDataStructure> GetOrRegisterProcessor(const std::wstring &name, const std::wstring &type) {
-    std::shared_ptr<Registry> current_registry;
-    std::shared_ptr<IDataStructure> processor = nullptr;
+  // Handle of name, registering a processor of type for it if it is new.
+  // Returns kInvalidHandle (and logs) if type is unknown.
+  Handle Register(Symbol name, Symbol type) {
+    Handle handle = registry_.Register(name, [&]() { return CreateDataStructure(type); });
+    if (handle == kInvalidHandle) {
+      LOG_ERROR(L"Error: Failed to create or find data structure: %ls\n", name.Name().c_str());
+    }
+    return handle;
+  }
 
-    while (true) {
-      current_registry = std::atomic_load(&registry_);
-      auto proc_it = current_registry->processors.find(name);
-      if (proc_it != current_registry->processors.end()) {
-        return proc_it->second;
-      }
+  // Arena for context data built on the calling thread. Contexts allocate
+  // their per-row records here; all of it is released in one step when the
+  // DataHelper goes away, after the contexts themselves.
+  BumpArena &ContextArena() { return arenas_.Local(); }
 
-      auto new_registry = std::make_shared<Registry>(*current_registry);
-      processor = CreateDataStructure(type, *new_registry);
-      if (processor) {
-        new_registry->processors[name] = processor;
-      }
+  void LogArenaStats() const {
+    ArenaSet::Stats stats = arenas_.GetStats();
+    LOG_INFO(L"Context arena: %zu allocations (%zu bytes) in %zu blocks across %zu threads\n", stats.allocations,
+             stats.bytes, stats.blocks, stats.arenas);
+  }
 
-      if (std::atomic_compare_exchange_strong(&registry_, &current_registry, new_registry)) {
-        return processor;
-      }
-    }
+  std::shared_ptr<IDataStructure> GetOrRegisterProcessor(Symbol name, Symbol type) {
+    return GetDataStructure(Register(name, type));
   }
 
-  void ExecuteData(const std::wstring &name, std::wstring &key, const std::wstring type, const std::vector<std::any> &args, std::any *specific_context = nullptr) {
-    std::shared_ptr<Registry> current_registry;
-    std::shared_ptr<IDataStructure> processor = nullptr;
-    std::any *context_ptr = specific_context;
+  void ExecuteData(Symbol name, std::wstring &key, Symbol type, const std::vector<std::any> &args, std::any *specific_context = nullptr) {
+    ExecuteData(Register(name, type), key, args, specific_context);
+  }
 
-    // CAS Loop: Optimistic concurrency control
-    while (true) {
-      current_registry = std::atomic_load(&registry_);
+  void ExecuteData(Handle handle, std::wstring &key, const std::vector<std::any> &args, std::any *specific_context = nullptr) {
+    if (handle == kInvalidHandle) {
+      return;
+    }
+    auto &slot = registry_.At(handle);
+    std::any &context = specific_context ? *specific_context : DataRegistry::EnsureContext(slot);
+    slot.processor->ConstructDataStructure(context, args, key);
+  }
 
-      // 1. Check if we have everything we need in the current snapshot
-      auto proc_it = current_registry->processors.find(name);
-      bool has_processor = (proc_it != current_registry->processors.end());
-      bool has_context = (current_registry->contexts.find(name) != current_registry->contexts.end());
+  // Row-batch counterpart of ExecuteData: one registry lookup per batch instead of per cell.
+  void ExecuteRows(Symbol name, Symbol type, const CellRowSpan &rows, const std::wstring &key = L"", std::any *specific_context = nullptr) {
+    ExecuteRows(Register(name, type), rows, key, specific_context);
+  }
 
-      if (has_processor && (context_ptr || has_context)) {
-        // Fast path: Everything exists, just use it.
-        processor = proc_it->second;
-        if (!context_ptr) {
-          // We can safely take the address because the registry is immutable (shared_ptr keeps it alive)
-          // Note: const_cast is needed because we store contexts in a const map in the snapshot
-          context_ptr = const_cast<std::any *>(&current_registry->contexts.at(name));
-        }
-        break;
-      }
+  void ExecuteRows(Handle handle, const CellRowSpan &rows, const std::wstring &key = L"", std::any *specific_context = nullptr) {
+    if (handle == kInvalidHandle) {
+      return;
+    }
+    auto &slot = registry_.At(handle);
+    std::any &context = specific_context ? *specific_context : DataRegistry::EnsureContext(slot);
+    slot.processor->ConstructFromRows(context, rows, key);
+  }
 
-      // 2. Slow path: Need to update state. Create a new copy (Copy-On-Write).
-      auto new_registry = std::make_shared<Registry>(*current_registry);
-
-      // Ensure Processor exists
-      if (!has_processor) {
-        processor = CreateDataStructure(type, *new_registry);
-        if (processor) {
-          new_registry->processors[name] = processor;
-        }
-      } else {
-        processor = new_registry->processors[name];
-      }
+  // Dumps the context of name to its regression log, at debug level.
+  void PrintData(Symbol name) {
+    Handle handle = registry_.Find(name);
+    if (handle == kInvalidHandle || !Logger::IsEnabled(LogLevel::DEBUG)) {
+      return;
+    }
+    auto &slot = registry_.At(handle);
+    if (std::any *context = DataRegistry::Context(slot)) {
+      std::filesystem::create_directories("regression");
+      Logger::StartSecondaryLog("regression/" + Cts(name.Name()) + ".log");
 
-      // Ensure Context exists (only if we are not using specific_context)
-      if (!specific_context && processor && new_registry->contexts.find(name) == new_registry->contexts.end()) {
-        new_registry->contexts[name] = processor->CreateContext();
-      }
+      slot.processor->PrintDataStructure(*context);
 
-      // 3. Atomic Swap
-      if (std::atomic_compare_exchange_strong(&registry_, &current_registry, new_registry)) {
-        // Success! The new registry is now the source of truth.
-        // Update our local pointers to point to the new data
-        if (processor && !specific_context) {
-          context_ptr = &new_registry->contexts[name];
-        }
-        break;
-      }
-      // If CAS failed, another thread updated the registry. Loop again and retry with the new state.
+      Logger::StopSecondaryLog();
     }
+  }
 
-    if (processor && context_ptr) {
-      processor->ConstructDataStructure(*context_ptr, args, key);
-    } else {
-      Logger::Log(L"Error: Failed to create or find data structure: %ls\n", name.c_str());
-    }
+  std::shared_ptr<IDataStructure> GetDataStructure(Symbol name) {
+    return GetDataStructure(registry_.Find(name));
   }
 
-  void PrintData(const std::wstring &name) {
-    auto current_registry = std::atomic_load(&registry_);
+  std::shared_ptr<IDataStructure> GetDataStructure(Handle handle) {
+    return handle != kInvalidHandle ? registry_.At(handle).processor : nullptr;
+  }
 
-    auto proc_it = current_registry->processors.find(name);
-    if (proc_it != current_registry->processors.end()) {
-      auto ctx_it = current_registry->contexts.find(name);
-      if (ctx_it != current_registry->contexts.end()) {
-        // Safe to read from the snapshot
-        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-        std::string str_name = converter.to_bytes(name);
+  // Merges contexts, in order, into the context of name (created if missing).
+  void MergeContexts(Symbol name, std::vector<std::any> contexts) {
+    MergeContexts(registry_.Find(name), std::move(contexts));
+  }
 
-        std::filesystem::create_directories("regression");
-        Logger::StartSecondaryLog("regression/" + str_name + ".log");
+  void MergeContexts(Handle handle, std::vector<std::any> contexts) {
+    if (handle == kInvalidHandle || contexts.empty()) {
+      return;
+    }
+    auto &slot = registry_.At(handle);
+    DataRegistry::Commit(slot, ReduceContexts(*slot.processor, std::move(contexts)));
+  }
 
-        proc_it->second->PrintDataStructure(const_cast<std::any &>(ctx_it->second));
+  // Combines contexts into one, keeping their order: runs of neighbours are
+  // spliced on the pool, then the runs are spliced pairwise. Returns an
+  // empty std::any if contexts is empty.
+  static std::any ReduceContexts(IDataStructure &processor, std::vector<std::any> contexts) {
+    return ParallelReduce(
+        IndexRange{0, contexts.size()}, 1, std::any(),
+        [&processor, &contexts](IndexRange run) {
+          std::any context = std::move(contexts[run.begin]);
+          for (size_t i = run.begin + 1; i < run.end; ++i) {
+            processor.SpliceDataStructure(context, std::move(contexts[i]));
+            contexts[i].reset();
+          }
+          return context;
+        },
+        [&processor](std::any &&left, std::any &&right) {
+          processor.SpliceDataStructure(left, std::move(right));
+          return std::move(left);
+        },
+        WorkerPool());
+  }
 
-        Logger::StopSecondaryLog();
-      }
+  // The shared pool, or nullptr when the core type is single_thread, for
+  // ParallelFor and ParallelReduce.
+  static ThreadPool *WorkerPool() {
+    if (Environments::GlobalEnvironment::GetInstance().GetCoreType() == Environments::ExecutionMode::SINGLE_THREAD) {
+      return nullptr;
     }
+    return &ThreadPool::GetInstance();
   }
 
-  std::shared_ptr<IDataStructure> GetDataStructure(const std::wstring &name) {
-    auto current_registry = std::atomic_load(&registry_);
-    auto it = current_registry->processors.find(name);
-    if (it != current_registry->processors.end()) {
-      return it->second;
+  std::any *GetDataContext(Symbol name) {
+    Handle handle = registry_.Find(name);
+    return handle != kInvalidHandle ? DataRegistry::Context(registry_.At(handle)) : nullptr;
+  }
+
+  // Publishes a context that was built privately (e.g. on a worker) under name.
+  // If name already has a context, the new one is merged into it instead.
+  void CommitContext(Symbol name, Symbol type, std::any context) {
+    Handle handle = Register(name, type);
+    if (handle != kInvalidHandle) {
+      DataRegistry::Commit(registry_.At(handle), std::move(context));
     }
-    return nullptr;
   }
 
-  void MergeContexts(const std::wstring &name, const std::vector<std::any> &contexts) {
-    auto processor = GetDataStructure(name);
-    if (!processor) {
-      return;
+  // Snapshot cache (environments: snapshot_dir). Loads the context saved
+  // under key by an earlier run and commits it as name. Returns false on a
+  // miss, or if the snapshot is stale or unreadable, so the caller rebuilds.
+  bool LoadSnapshot(Symbol name, Symbol type, const std::string &key) {
+    std::string path = SnapshotPath(key);
+    if (path.empty()) {
+      return false;
+    }
+    MappedFile file(path);
+    if (!file.IsOpen() || file.View().empty()) {
+      return false;
     }
 
-    // Ensure global context exists
-    std::any *global_context = nullptr;
+    SnapshotReader in(file.View());
+    uint32_t magic = 0, version = 0, wchar_size = 0;
+    std::wstring stored_type;
+    if (!in.Get(magic) || magic != Snapshot::kMagic || !in.Get(version) || version != Snapshot::kVersion ||
+        !in.Get(wchar_size) || wchar_size != sizeof(wchar_t) || !in.GetString(stored_type) || stored_type != type.Name()) {
+      LOG_INFO(L"Snapshot %ls does not match this build, rebuilding %ls\n", Ctw(path).c_str(), name.Name().c_str());
+      return false;
+    }
 
-    // Retry loop to ensure context exists
-    while (true) {
-      auto current_registry = std::atomic_load(&registry_);
-      auto it = current_registry->contexts.find(name);
-      if (it != current_registry->contexts.end()) {
-        global_context = const_cast<std::any *>(&it->second);
-        break;
-      }
+    auto processor = GetOrRegisterProcessor(name, type);
+    if (!processor) {
+      return false;
+    }
+    std::any context = processor->CreateContext();
+    if (!processor->LoadContext(in, context) || !in.AtEnd()) {
+      LOG_WARN(L"Snapshot %ls is corrupt, rebuilding %ls\n", Ctw(path).c_str(), name.Name().c_str());
+      return false;
+    }
+    CommitContext(name, type, std::move(context));
+    LOG_INFO(L"Loaded %ls from snapshot %ls\n", name.Name().c_str(), Ctw(path).c_str());
+    return true;
+  }
 
-      // Create new registry with context
-      auto new_registry = std::make_shared<Registry>(*current_registry);
-      new_registry->contexts[name] = processor->CreateContext();
+  // Saves context, built from the source and range behind key alone, under
+  // key if its structure supports snapshots. Call it before the context is
+  // committed, since name may hold rows from other sources as well.
+  void SaveSnapshot(Symbol name, Symbol type, const std::string &key, const std::any &context) {
+    std::string path = SnapshotPath(key);
+    auto processor = GetOrRegisterProcessor(name, type);
+    if (path.empty() || !processor || !context.has_value()) {
+      return;
+    }
 
-      if (std::atomic_compare_exchange_strong(&registry_, &current_registry, new_registry)) {
-        global_context = &new_registry->contexts[name];
-        break;
+    SnapshotWriter out;
+    out.Put(Snapshot::kMagic);
+    out.Put(Snapshot::kVersion);
+    out.Put(static_cast<uint32_t>(sizeof(wchar_t)));
+    out.PutString(type.Name());
+    if (!processor->SaveContext(context, out)) {
+      return;
+    }
+
+    // Written aside and renamed, so a reader never maps a partial file
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::string temp_path = path + ".tmp";
+    {
+      std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+      file.write(out.Buffer().data(), static_cast<std::streamsize>(out.Buffer().size()));
+      if (!file) {
+        LOG_WARN(L"Warning: Failed to write snapshot %ls\n", Ctw(temp_path).c_str());
+        return;
       }
     }
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+      LOG_WARN(L"Warning: Failed to write snapshot %ls\n", Ctw(path).c_str());
+    }
+  }
 
-    for (const auto &local_ctx : contexts) {
-      processor->MergeDataStructure(*global_context, local_ctx);
+ private:
+  // Declared before the registry, so it outlives every context
+  ArenaSet arenas_;
+  DataRegistry registry_;
+  // One processor instance per type, shared by every name of that type
+  std::mutex type_mutex_;
+  std::array<std::shared_ptr<IDataStructure>, Symbols::kWellKnownCount> type_cache_;
+
+  // Snapshot file for key, or empty when the cache is disabled.
+  static std::string SnapshotPath(const std::string &key) {
+    const std::string &dir = Environments::GlobalEnvironment::GetInstance().GetSnapshotDir();
+    if (dir.empty()) {
+      return "";
     }
+    return (std::filesystem::path(dir) / (key + ".snap")).string();
+  }
+
+  template <typename T>
+  static std::shared_ptr<IDataStructure> Make(const std::shared_ptr<DataHelper> &self) {
+    return std::make_shared<T>(self);
   }
 
-  std::any *GetDataContext(const std::wstring &name) {
-    auto current_registry = std::atomic_load(&registry_);
-    auto it = current_registry->contexts.find(name);
-    if (it != current_registry->contexts.end()) {
-      return const_cast<std::any *>(&it->second);
+  // True if entries[i] is the entry for the type whose symbol id is i.
+  template <typename Entry, size_t N>
+  static constexpr bool IsIndexedBySymbol(const Entry (&entries)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+      if (entries[i].type.Id() != i) {
+        return false;
+      }
     }
-    return nullptr;
+    return true;
   }
 
- private:
-  std::shared_ptr<Registry> registry_;
-
-  std::shared_ptr<IDataStructure> CreateDataStructure(const std::wstring &type, Registry &reg) {
-    // Check cache in the new registry being built
-    auto it = reg.type_cache.find(type);
-    if (it != reg.type_cache.end()) {
-      return it->second;
-    }
-
-    auto self = shared_from_this();
-    std::shared_ptr<IDataStructure> ds_instance = nullptr;
-    if (type == L"Code") {
-      ds_instance = std::make_shared<CodeDataStructure>(self);
-    } else if (type == L"Qx") {
-      ds_instance = std::make_shared<QxDataStructure>(self);
-    } else if (type == L"Termination") {
-      ds_instance = std::make_shared<TerminationDataStructure>(self);
-    } else if (type == L"Expense") {
-      ds_instance = std::make_shared<ExpenseDataStructure>(self);
-    } else if (type == L"SRatio") {
-      ds_instance = std::make_shared<SRatioDataStructure>(self);
-    } else if (type == L"Table") {
-      ds_instance = std::make_shared<TableDataStructure>(self);
-    } else if (type == L"InsuranceResult") {
-      ds_instance = std::make_shared<InsuranceResultDataStructure>(self);
-    } else if (type == L"InsuranceOutput") {
-      ds_instance = std::make_shared<InsuranceOutputDataStructure>(self);
-    } else if (type == L"ExpenseOutput") {
-      ds_instance = std::make_shared<ExpenseOutputDataStructure>(self);
-    } else {
-      Logger::Log(L"Warning: Unknown data structure type requested: %ls\n", type.c_str());
-    }
-
-    // Update cache in the new registry
-    if (ds_instance) {
-      reg.type_cache[type] = ds_instance;
-    }
-    return ds_instance;
+  std::shared_ptr<IDataStructure> CreateDataStructure(Symbol type) {
+    using Factory = std::shared_ptr<IDataStructure> (*)(const std::shared_ptr<DataHelper> &);
+    struct TypeEntry {
+      Symbol type;
+      Factory create;
+    };
+    // Indexed by the type's symbol id
+    static constexpr TypeEntry kTypes[] = {
+        {Symbols::kCode, &Make<CodeDataStructure>},
+        {Symbols::kQx, &Make<QxDataStructure>},
+        {Symbols::kTermination, &Make<TerminationDataStructure>},
+        {Symbols::kExpense, &Make<ExpenseDataStructure>},
+        {Symbols::kSRatio, &Make<SRatioDataStructure>},
+        {Symbols::kTable, &Make<TableDataStructure>},
+        {Symbols::kInsuranceResult, &Make<InsuranceResultDataStructure>},
+        {Symbols::kInsuranceOutput, &Make<InsuranceOutputDataStructure>},
+        {Symbols::kExpenseOutput, &Make<ExpenseOutputDataStructure>},
+    };
+    static_assert(std::size(kTypes) <= Symbols::kWellKnownCount, "type table exceeds the well-known symbols");
+    static_assert(IsIndexedBySymbol(kTypes), "type table must be ordered by symbol id");
+
+    if (type.Id() >= std::size(kTypes)) {
+      LOG_WARN(L"Warning: Unknown data structure type requested: %ls\n", type.Name().c_str());
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(type_mutex_);
+    auto &instance = type_cache_[type.Id()];
+    if (!instance) {
+      instance = kTypes[type.Id()].create(shared_from_this());
+    }
+    return instance;
   }
 };
 #endif  // SRC_DATAPROCESSOR_DATA_HELPER_H_
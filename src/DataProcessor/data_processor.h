@@ -16,8 +16,12 @@
 #include <any>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
+#include "DataProcessor/snapshot.h"
+
 class DataHelper;
 class IDataStructure {
  public:
@@ -26,9 +30,38 @@ class IDataStructure {
   virtual void ConstructDataStructure(std::any& context,
                                       const std::vector<std::any>& args,
                                       std::wstring& key) = 0;
+  // Row entry point: builds from a batch of typed, column-indexed rows.
+  // key names the owning source for structures keyed by file; sheet-backed
+  // structures take their keys from their key column instead.
+  // The default forwards each non-empty cell to the per-cell std::any path.
+  virtual void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                                 const std::wstring& key) {
+    for (const auto& row : rows) {
+      std::wstring row_key = key;
+      for (int col = row.first_col; col <= row.LastColumn(); ++col) {
+        const CellValue& value = row.Cell(col);
+        if (value.IsEmpty()) {
+          continue;
+        }
+        std::vector<std::any> args{value, col};
+        ConstructDataStructure(context, args, row_key);
+      }
+    }
+  }
   virtual void MergeDataStructure(std::any& /*target*/, const std::any& /*source*/) {}
+  // Merge that may take over source's contents (moving records, extracting
+  // map nodes) instead of copying them; source is left valid but
+  // unspecified. Appends in the same order as MergeDataStructure, which is
+  // what structures without a cheaper move fall back to.
+  virtual void SpliceDataStructure(std::any& target, std::any&& source) {
+    MergeDataStructure(target, static_cast<const std::any&>(source));
+  }
   virtual void PrintDataStructure(const std::any& context) const = 0;
   virtual std::any CreateContext() const = 0;
+  // Snapshot cache encoding of a built context. Structures that keep the
+  // defaults (returning false) are always rebuilt.
+  virtual bool SaveContext(const std::any& /*context*/, SnapshotWriter& /*out*/) const { return false; }
+  virtual bool LoadContext(SnapshotReader& /*in*/, std::any& /*context*/) const { return false; }
   virtual ~IDataStructure() = default;
 
  protected:
@@ -0,0 +1,165 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_DATA_REGISTRY_H_
+#define SRC_DATAPROCESSOR_DATA_REGISTRY_H_
+#include <any>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "DataProcessor/data_processor.h"
+#include "Utility/abort.h"
+#include "Utility/symbol_table.h"
+
+// Name -> (processor, context) registry behind DataHelper.
+// A name is registered once and gets a dense integer handle; after that the
+// processor and context are reached by indexing a slot array, without a
+// lookup or a lock. The name -> handle directory is split into shards with
+// their own reader/writer locks, so registrations of different names rarely
+// contend and lookups only take a shared lock.
+class DataRegistry {
+ public:
+  using Handle = uint32_t;
+  static constexpr Handle kInvalidHandle = UINT32_MAX;
+
+  struct Slot {
+    Symbol name;
+    // Set before the handle is published and never changed afterwards
+    std::shared_ptr<IDataStructure> processor;
+    // Published once; the slot owns it for the registry's lifetime
+    std::atomic<std::any*> context{nullptr};
+    std::unique_ptr<std::any> owned_context;
+    std::mutex context_mutex;  // guards creating or committing the context
+  };
+
+  DataRegistry() = default;
+  DataRegistry(const DataRegistry&) = delete;
+  DataRegistry& operator=(const DataRegistry&) = delete;
+
+  // Handle of name, or kInvalidHandle if it is not registered.
+  Handle Find(Symbol name) const {
+    const Shard& shard = ShardOf(name);
+    std::shared_lock lock(shard.mutex);
+    auto it = shard.handles.find(name);
+    return it != shard.handles.end() ? it->second : kInvalidHandle;
+  }
+
+  // Handle of name, registering it with the processor from create if it is
+  // new. Returns kInvalidHandle if create returns null.
+  Handle Register(Symbol name, const std::function<std::shared_ptr<IDataStructure>()>& create) {
+    Shard& shard = ShardOf(name);
+    {
+      std::shared_lock lock(shard.mutex);
+      auto it = shard.handles.find(name);
+      if (it != shard.handles.end()) {
+        return it->second;
+      }
+    }
+
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.handles.find(name);
+    if (it != shard.handles.end()) {
+      return it->second;
+    }
+    std::shared_ptr<IDataStructure> processor = create();
+    if (!processor) {
+      return kInvalidHandle;
+    }
+    Handle handle = AllocateSlot();
+    Slot& slot = At(handle);
+    slot.name = name;
+    slot.processor = std::move(processor);
+    shard.handles.emplace(name, handle);
+    return handle;
+  }
+
+  // Slot of a handle returned by Find or Register.
+  Slot& At(Handle handle) const {
+    return chunks_[handle / kChunkSize].load(std::memory_order_acquire)[handle % kChunkSize];
+  }
+
+  // The slot's context, or nullptr if none was created or committed yet.
+  static std::any* Context(Slot& slot) { return slot.context.load(std::memory_order_acquire); }
+
+  // The slot's context, created from its processor on first use.
+  static std::any& EnsureContext(Slot& slot) {
+    if (std::any* context = Context(slot)) {
+      return *context;
+    }
+    std::lock_guard<std::mutex> lock(slot.context_mutex);
+    if (!slot.owned_context) {
+      Publish(slot, std::make_unique<std::any>(slot.processor->CreateContext()));
+    }
+    return *slot.owned_context;
+  }
+
+  // Publishes a privately built context, or splices it into the existing one.
+  static void Commit(Slot& slot, std::any context) {
+    std::lock_guard<std::mutex> lock(slot.context_mutex);
+    if (slot.owned_context) {
+      slot.processor->SpliceDataStructure(*slot.owned_context, std::move(context));
+      return;
+    }
+    Publish(slot, std::make_unique<std::any>(std::move(context)));
+  }
+
+ private:
+  static constexpr size_t kShardCount = 16;
+  static constexpr size_t kChunkSize = 64;
+  static constexpr size_t kMaxChunks = 1024;
+
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Symbol, Handle> handles;
+  };
+
+  static void Publish(Slot& slot, std::unique_ptr<std::any> context) {
+    slot.owned_context = std::move(context);
+    slot.context.store(slot.owned_context.get(), std::memory_order_release);
+  }
+
+  Shard& ShardOf(Symbol name) { return shards_[name.Id() % kShardCount]; }
+  const Shard& ShardOf(Symbol name) const { return shards_[name.Id() % kShardCount]; }
+
+  // Slots live in fixed-size chunks that are never moved, so a Slot& stays
+  // valid while later registrations grow the array.
+  Handle AllocateSlot() {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    size_t index = slot_count_;
+    size_t chunk = index / kChunkSize;
+    if (chunk >= kMaxChunks) {
+      Abort(L"Data registry is full (%zu names)\n", kMaxChunks * kChunkSize);
+    }
+    if (index % kChunkSize == 0) {
+      chunk_storage_[chunk] = std::make_unique<Slot[]>(kChunkSize);
+      chunks_[chunk].store(chunk_storage_[chunk].get(), std::memory_order_release);
+    }
+    ++slot_count_;
+    return static_cast<Handle>(index);
+  }
+
+  std::array<Shard, kShardCount> shards_;
+  std::array<std::atomic<Slot*>, kMaxChunks> chunks_{};
+  std::array<std::unique_ptr<Slot[]>, kMaxChunks> chunk_storage_;
+  std::mutex slots_mutex_;
+  size_t slot_count_ = 0;
+};
+
+#endif  // SRC_DATAPROCESSOR_DATA_REGISTRY_H_
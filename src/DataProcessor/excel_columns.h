@@ -43,4 +43,11 @@ constexpr int QX_TABLE_END = 42;
 constexpr int QX_VALUES_START = 43;  // Columns 43+ are qx values
 }  // namespace CodeColumns
 
+// Excel Column Indices for Termination Data Structure (1-indexed)
+namespace TerminationColumns {
+constexpr int KEY = 2;
+constexpr int FIRST_RATE = 3;  // duration 10
+constexpr int LAST_RATE = 23;  // duration 30
+}  // namespace TerminationColumns
+
 #endif  // SRC_DATAPROCESSOR_EXCEL_COLUMNS_H_
@@ -13,32 +13,59 @@
 // ============================================================================
 #include "DataProcessor/expense_data_structure.h"
 
+#include <algorithm>
 #include <any>
+#include <climits>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
+#include "DataProcessor/data_helper.h"
 #include "Logger/logger.h"
 void ExpenseDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   auto& expense_table = std::any_cast<ExpenseTableMap&>(context);
-  int key_to_int{0};
-  std::wstring input = std::any_cast<std::wstring>(args[0]);
+  const auto& input = std::any_cast<const CellValue&>(args[0]);
   int column = std::any_cast<int>(args[1]);
   if (column == 1) {
-    key = input;
+    key = input.ToWString();
     return;
   }
-  auto toInt = [](const std::wstring& str) -> int { return std::stoi(str); };
-  auto toDouble = [](const std::wstring& str) -> float {
-    return std::stod(str);
-  };
-  key_to_int = toInt(key);
-  auto& current_expense_table = expense_table[key_to_int];
-  std::shared_ptr<ExpenseTable> new_qx_table;
+  SetField(GetDataHelper()->ContextArena(), expense_table[std::stoi(key)], column, input);
+}
+
+void ExpenseDataStructure::ConstructFromRows(std::any& context, const CellRowSpan& rows, const std::wstring& /*key*/) {
+  auto& expense_table = std::any_cast<ExpenseTableMap&>(context);
+  BumpArena& arena = GetDataHelper()->ContextArena();
+  for (const auto& row : rows) {
+    const CellValue& key_cell = row.Cell(1);
+    if (key_cell.IsEmpty()) {
+      continue;
+    }
+    int key_to_int = static_cast<int>(key_cell.AsInt());
+    std::vector<std::shared_ptr<ExpenseTable>>* current_expense_table = nullptr;
+    for (int column = 2; column <= row.LastColumn(); ++column) {
+      const CellValue& input = row.Cell(column);
+      if (input.IsEmpty()) {
+        continue;
+      }
+      // Only rows that carry data create an entry for their key
+      if (!current_expense_table) {
+        current_expense_table = &expense_table[key_to_int];
+      }
+      SetField(arena, *current_expense_table, column, input);
+    }
+  }
+}
+
+void ExpenseDataStructure::SetField(BumpArena& arena, std::vector<std::shared_ptr<ExpenseTable>>& current_expense_table, int column, const CellValue& input) {
+  auto toInt = [](const CellValue& value) -> int { return static_cast<int>(value.AsInt()); };
+  auto toDouble = [](const CellValue& value) -> double { return value.AsDouble(); };
   switch (column) {
     case 2:
-      new_qx_table = std::make_shared<ExpenseTable>();
-      current_expense_table.emplace_back(new_qx_table);
+      current_expense_table.emplace_back(arena.MakeShared<ExpenseTable>());
       current_expense_table.back()->mm = toInt(input);
       break;
     case 3:
@@ -71,19 +98,111 @@ void ExpenseDataStructure::MergeDataStructure(std::any& target, const std::any&
   }
 }
 
+void ExpenseDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  auto& target_map = std::any_cast<ExpenseTableMap&>(target);
+  auto& source_map = std::any_cast<ExpenseTableMap&>(source);
+
+  // Keys new to target move over as whole map nodes; the records of shared
+  // keys are moved onto the end of target's list
+  for (auto it = source_map.begin(); it != source_map.end();) {
+    auto target_it = target_map.find(it->first);
+    if (target_it == target_map.end()) {
+      target_map.insert(source_map.extract(it++));
+      continue;
+    }
+    auto& target_vec = target_it->second;
+    target_vec.insert(target_vec.end(), std::make_move_iterator(it->second.begin()),
+                      std::make_move_iterator(it->second.end()));
+    ++it;
+  }
+}
+
 void ExpenseDataStructure::PrintDataStructure(const std::any& context) const {
   const auto& expense_table = std::any_cast<const ExpenseTableMap&>(context);
   for (const auto& entry : expense_table) {
     int dnum = entry.first;
     auto current_expense_table = entry.second;
-    Logger::Log(L"expense dnum: %d\n", dnum);
+    LOG_DEBUG(L"expense dnum: %d\n", dnum);
     for (const auto& iter : current_expense_table) {
-      Logger::Log(L"  mm: %d", iter->mm);
-      Logger::Log(L" ap: %lf", iter->ap);
-      Logger::Log(L" bp: %lf", iter->bp);
-      Logger::Log(L" bs: %lf", iter->bs);
-      Logger::Log(L" b2: %lf", iter->b2);
-      Logger::Log(L" bo: %lf\n", iter->bo);
+      LOG_DEBUG(L"  mm: %d", iter->mm);
+      LOG_DEBUG(L" ap: %lf", iter->ap);
+      LOG_DEBUG(L" bp: %lf", iter->bp);
+      LOG_DEBUG(L" bs: %lf", iter->bs);
+      LOG_DEBUG(L" b2: %lf", iter->b2);
+      LOG_DEBUG(L" bo: %lf\n", iter->bo);
+    }
+  }
+}
+
+ExpenseGrid ExpenseDataStructure::BuildGrid(const ExpenseTableMap& expense_map) {
+  int min_dnum = INT_MAX, max_dnum = INT_MIN, min_mm = INT_MAX, max_mm = INT_MIN;
+  for (const auto& [dnum, expense_tables] : expense_map) {
+    for (const auto& expense_table : expense_tables) {
+      min_dnum = std::min(min_dnum, dnum);
+      max_dnum = std::max(max_dnum, dnum);
+      min_mm = std::min(min_mm, expense_table->mm);
+      max_mm = std::max(max_mm, expense_table->mm);
+    }
+  }
+  if (min_dnum > max_dnum) {
+    return ExpenseGrid();
+  }
+
+  ExpenseGrid grid(min_dnum, max_dnum, min_mm, max_mm);
+  for (const auto& [dnum, expense_tables] : expense_map) {
+    for (const auto& expense_table : expense_tables) {
+      grid.SetIfAbsent(dnum, expense_table->mm,
+                       ExpenseRates{expense_table->ap, expense_table->bp, expense_table->bs, expense_table->b2,
+                                    expense_table->bo});
+    }
+  }
+  return grid;
+}
+
+bool ExpenseDataStructure::SaveContext(const std::any& context, SnapshotWriter& out) const {
+  const auto& expense_map = std::any_cast<const ExpenseTableMap&>(context);
+  out.Put<uint64_t>(expense_map.size());
+  for (const auto& [code, tables] : expense_map) {
+    out.Put(code);
+    out.Put<uint64_t>(tables.size());
+    for (const auto& table : tables) {
+      if (!table) {
+        return false;
+      }
+      out.Put(table->mm);
+      out.Put(table->ap);
+      out.Put(table->bp);
+      out.Put(table->bs);
+      out.Put(table->b2);
+      out.Put(table->bo);
+    }
+  }
+  return true;
+}
+
+bool ExpenseDataStructure::LoadContext(SnapshotReader& in, std::any& context) const {
+  BumpArena& arena = GetDataHelper()->ContextArena();
+  auto& expense_map = std::any_cast<ExpenseTableMap&>(context);
+  uint64_t count = 0;
+  if (!in.GetCount(count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    int code = 0;
+    uint64_t table_count = 0;
+    if (!in.Get(code) || !in.GetCount(table_count)) {
+      return false;
+    }
+    auto& tables = expense_map[code];
+    tables.reserve(table_count);
+    for (uint64_t j = 0; j < table_count; ++j) {
+      auto table = arena.MakeShared<ExpenseTable>();
+      if (!in.Get(table->mm) || !in.Get(table->ap) || !in.Get(table->bp) || !in.Get(table->bs) ||
+          !in.Get(table->b2) || !in.Get(table->bo)) {
+        return false;
+      }
+      tables.push_back(std::move(table));
     }
   }
+  return true;
 }
@@ -15,10 +15,13 @@
 #define SRC_DATAPROCESSOR_EXPENSE_DATA_STRUCTURE_H_
 #include <any>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
+#include "DataProcessor/expense_grid.h"
+#include "Utility/arena.h"
 struct ExpenseTable {
   int mm;
   double ap;
@@ -36,9 +39,22 @@ class ExpenseDataStructure : public IDataStructure {
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
   std::any CreateContext() const override { return ExpenseTableMap(); }
+  bool SaveContext(const std::any& context, SnapshotWriter& out) const override;
+  bool LoadContext(SnapshotReader& in, std::any& context) const override;
+
+  // Dense (dnum, mm) grid over every row of expense_map, sized to the dnum
+  // and mm ranges it contains. The first row for a pair wins.
+  static ExpenseGrid BuildGrid(const ExpenseTableMap& expense_map);
+
+ private:
+  static void SetField(BumpArena& arena, std::vector<std::shared_ptr<ExpenseTable>>& current_expense_table,
+                       int column, const CellValue& input);
 };
 
 #endif  // SRC_DATAPROCESSOR_EXPENSE_DATA_STRUCTURE_H_
@@ -0,0 +1,105 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_EXPENSE_GRID_H_
+#define SRC_DATAPROCESSOR_EXPENSE_GRID_H_
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Utility/abort.h"
+
+// Expense loadings of one (dnum, mm) pair.
+struct ExpenseRates {
+  double alp = 0.0;
+  double beta1 = 0.0;
+  double beta2 = 0.0;
+  double beta3 = 0.0;
+  double gamma = 0.0;
+};
+
+// Dense (dnum, mm) grid of expense rates, sized to the dnum and mm ranges
+// given at construction, so a lookup is an index computation. Lookups
+// outside the ranges, or of pairs that were never set, return nullptr.
+class ExpenseGrid {
+ public:
+  // Upper bound on cells, so a stray dnum or mm cannot allocate gigabytes.
+  static constexpr int64_t kMaxCells = int64_t{1} << 24;
+
+  ExpenseGrid() = default;
+  ExpenseGrid(int min_dnum, int max_dnum, int min_mm, int max_mm)
+      : min_dnum_(min_dnum),
+        dnum_count_(max_dnum - min_dnum + 1),
+        min_mm_(min_mm),
+        mm_count_(max_mm - min_mm + 1) {
+    int64_t cells = static_cast<int64_t>(dnum_count_) * mm_count_;
+    if (dnum_count_ <= 0 || mm_count_ <= 0 || cells > kMaxCells) {
+      Abort(L"Expense grid dnum %d..%d x mm %d..%d is out of range\n", min_dnum, max_dnum, min_mm, max_mm);
+    }
+    rates_.resize(static_cast<size_t>(cells));
+    present_.resize(static_cast<size_t>(cells), 0);
+    dnum_present_.resize(static_cast<size_t>(dnum_count_), 0);
+  }
+
+  bool empty() const { return rates_.empty(); }
+  int MinDnum() const { return min_dnum_; }
+  int MaxDnum() const { return min_dnum_ + dnum_count_ - 1; }
+  int MinMm() const { return min_mm_; }
+  int MaxMm() const { return min_mm_ + mm_count_ - 1; }
+
+  // Whether any mm was set for dnum.
+  bool HasDnum(int dnum) const {
+    int64_t d = static_cast<int64_t>(dnum) - min_dnum_;
+    return d >= 0 && d < dnum_count_ && dnum_present_[d];
+  }
+
+  const ExpenseRates* Find(int dnum, int mm) const {
+    int64_t cell = Cell(dnum, mm);
+    return cell >= 0 && present_[cell] ? &rates_[cell] : nullptr;
+  }
+
+  // Sets (dnum, mm) unless it is already set: the first row for a pair wins.
+  // Returns false if the pair is outside the grid.
+  bool SetIfAbsent(int dnum, int mm, const ExpenseRates& rates) {
+    int64_t cell = Cell(dnum, mm);
+    if (cell < 0) {
+      return false;
+    }
+    if (!present_[cell]) {
+      rates_[cell] = rates;
+      present_[cell] = 1;
+      dnum_present_[cell / mm_count_] = 1;
+    }
+    return true;
+  }
+
+ private:
+  int64_t Cell(int dnum, int mm) const {
+    int64_t d = static_cast<int64_t>(dnum) - min_dnum_;
+    int64_t m = static_cast<int64_t>(mm) - min_mm_;
+    if (d < 0 || d >= dnum_count_ || m < 0 || m >= mm_count_) {
+      return -1;
+    }
+    return d * mm_count_ + m;
+  }
+
+  int min_dnum_ = 0;
+  int dnum_count_ = 0;
+  int min_mm_ = 0;
+  int mm_count_ = 0;
+  std::vector<ExpenseRates> rates_;
+  std::vector<uint8_t> present_;
+  std::vector<uint8_t> dnum_present_;
+};
+
+#endif  // SRC_DATAPROCESSOR_EXPENSE_GRID_H_
@@ -15,6 +15,7 @@
 
 #include <any>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "DataProcessor/data_helper.h"
@@ -22,31 +23,29 @@
 #include "Logger/logger.h"
 #include "Utility/abort.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
 void ExpenseOutputDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   (void)key;   // Unused parameter
   (void)args;  // Unused parameter
   auto& expense_output_context = std::any_cast<ExpenseOutputContext&>(context);
-  std::shared_ptr<ExpenseOutput> output_ptr = std::make_shared<ExpenseOutput>();
   try {
     std::shared_ptr<DataHelper> data_helper = GetDataHelper();
-    const auto& expense_data_context_ptr = data_helper->GetDataContext(L"Expense");
+    const auto& expense_data_context_ptr = data_helper->GetDataContext(Symbols::kExpense);
     if (!expense_data_context_ptr) {
       Abort(L"Failed to get ExpenseData context\n");
     }
     const auto& expense_data_map = std::any_cast<const ExpenseDataStructure::ExpenseTableMap&>(*expense_data_context_ptr);
-    for (const auto& [key_int, expense_tables] : expense_data_map) {
-      for (const auto& expense_table : expense_tables) {
-        output_ptr->alp_in[key_int][expense_table->mm] = expense_table->ap;
-        output_ptr->beta1_in[key_int][expense_table->mm] = expense_table->bp;
-        output_ptr->beta2_in[key_int][expense_table->mm] = expense_table->bs;
-        output_ptr->beta3_in[key_int][expense_table->mm] = expense_table->b2;
-        output_ptr->gamma_in[key_int][expense_table->mm] = expense_table->bo;
-      }
-    }
-    expense_output_context.output = output_ptr;
-    GetDataHelper()->PrintData(L"ExpenseOutput");
+    expense_output_context.grid = std::make_shared<const ExpenseGrid>(ExpenseDataStructure::BuildGrid(expense_data_map));
+    GetDataHelper()->PrintData(Symbols::kExpenseOutput);
   } catch (const std::exception& e) {
-    Logger::Log(L"Error in ExpenseOutputDataStructure::ConstructDataStructure: %ls\n", Ctw(e.what()).c_str());
+    LOG_ERROR(L"Error in ExpenseOutputDataStructure::ConstructDataStructure: %ls\n", Ctw(e.what()).c_str());
+  }
+}
+
+// ExpenseOutput is derived from the Expense context, not read from sheet rows.
+void ExpenseOutputDataStructure::ConstructFromRows(std::any& /*context*/, const CellRowSpan& rows, const std::wstring& key) {
+  if (rows.size() > 0) {
+    LOG_WARN(L"Warning: ExpenseOutputDataStructure does not take row input, ignoring %zu rows for %ls\n", rows.size(), key.c_str());
   }
 }
 
@@ -54,47 +53,52 @@ void ExpenseOutputDataStructure::MergeDataStructure(std::any& target, const std:
   auto& target_ctx = std::any_cast<ExpenseOutputContext&>(target);
   const auto& source_ctx = std::any_cast<const ExpenseOutputContext&>(source);
 
-  if (!source_ctx.output) {
+  if (!source_ctx.grid) {
     return;
   }
 
-  target_ctx.output = source_ctx.output;
+  target_ctx.grid = source_ctx.grid;
+}
+
+void ExpenseOutputDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  auto& source_ctx = std::any_cast<ExpenseOutputContext&>(source);
+  if (source_ctx.grid) {
+    std::any_cast<ExpenseOutputContext&>(target).grid = std::move(source_ctx.grid);
+  }
 }
 
 void ExpenseOutputDataStructure::PrintDataStructure(const std::any& context) const {
   try {
     const auto& expense_output_context = std::any_cast<const ExpenseOutputContext&>(context);
-    if (!expense_output_context.output) {
-      Logger::Log(L"ExpenseOutputDataStructure: Context is empty.\n");
+    if (!expense_output_context.grid) {
+      LOG_DEBUG(L"ExpenseOutputDataStructure: Context is empty.\n");
       return;
     }
 
-    const auto& output = expense_output_context.output;
-    Logger::Log(L"=== Expense Output Data Structure ===\n");
+    const ExpenseGrid& grid = *expense_output_context.grid;
+    LOG_DEBUG(L"=== Expense Output Data Structure ===\n");
 
-    for (int i = 0; i < 10; ++i) {
-      for (int j = 0; j < 30; ++j) {
-        if (output->alp_in[i][j] != 0.0 || output->beta1_in[i][j] != 0.0 ||
-            output->beta2_in[i][j] != 0.0 || output->beta3_in[i][j] != 0.0 ||
-            output->gamma_in[i][j] != 0.0) {
-          Logger::Log(
+    for (int dnum = grid.MinDnum(); !grid.empty() && dnum <= grid.MaxDnum(); ++dnum) {
+      for (int mm = grid.MinMm(); mm <= grid.MaxMm(); ++mm) {
+        const ExpenseRates* rates = grid.Find(dnum, mm);
+        if (rates && (rates->alp != 0.0 || rates->beta1 != 0.0 || rates->beta2 != 0.0 ||
+                      rates->beta3 != 0.0 || rates->gamma != 0.0)) {
+          LOG_DEBUG(
               L"Index [%d][%d]: alp_in=%.6f, beta1_in=%.6f, beta2_in=%.6f, "
               L"beta3_in=%.6f, gamma_in=%.6f\n",
-              i, j, output->alp_in[i][j], output->beta1_in[i][j],
-              output->beta2_in[i][j], output->beta3_in[i][j],
-              output->gamma_in[i][j]);
+              dnum, mm, rates->alp, rates->beta1, rates->beta2, rates->beta3, rates->gamma);
         }
       }
     }
-    Logger::Log(L"=====================================\n");
+    LOG_DEBUG(L"=====================================\n");
 
   } catch (const std::bad_any_cast& e) {
-    Logger::Log(
+    LOG_ERROR(
         L"Error in ExpenseOutputDataStructure::PrintDataStructure: Bad any cast "
         L"- %ls\n",
         Ctw(e.what()).c_str());
   } catch (const std::exception& e) {
-    Logger::Log(L"Error in ExpenseOutputDataStructure::PrintDataStructure: %ls\n",
-                Ctw(e.what()).c_str());
+    LOG_ERROR(L"Error in ExpenseOutputDataStructure::PrintDataStructure: %ls\n",
+              Ctw(e.what()).c_str());
   }
 }
@@ -19,15 +19,11 @@
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
-struct ExpenseOutput {
-  double alp_in[10][30];
-  double beta1_in[10][30];
-  double beta2_in[10][30];
-  double beta3_in[10][30];
-  double gamma_in[10][30];
-};
+#include "DataProcessor/expense_grid.h"
+// Built once from the Expense context after the Expense sheet is read and
+// shared read-only by every per-policy calculation.
 struct ExpenseOutputContext {
-  std::shared_ptr<ExpenseOutput> output;
+  std::shared_ptr<const ExpenseGrid> grid;
 };
 
 class ExpenseOutputDataStructure : public IDataStructure {
@@ -37,7 +33,10 @@ class ExpenseOutputDataStructure : public IDataStructure {
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
   std::any CreateContext() const override { return ExpenseOutputContext(); }
 };
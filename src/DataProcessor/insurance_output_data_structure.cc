@@ -15,7 +15,10 @@
 
 #include <algorithm>
 #include <any>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "DataProcessor/code_data_structure.h"
@@ -27,6 +30,146 @@
 #include "Logger/logger.h"
 #include "Utility/abort.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
+#include "Utility/parallel.h"
+namespace {
+
+// Fewest policies a chunk gathers.
+constexpr size_t kPolicyGrain = 64;
+
+// One input column of a source table. Unset columns, and rows too short to
+// have the column, read as 0.
+struct PlanColumn {
+  std::optional<TableColumnView> view;
+
+  double At(size_t row) const { return view ? static_cast<double>((*view)[row]) : 0.0; }
+};
+
+// Column indices and tables of one calc_insurance_output command, resolved
+// once so the per-policy gather only indexes columns.
+struct OutputPlan {
+  const TableData* tvn_table = nullptr;
+  const TableData* std_np_table = nullptr;
+  bool has_tvn = false;
+  bool has_tvn_end = false;
+  bool has_alpha = false;
+  bool has_np = false;
+  bool has_std_np = false;
+  PlanColumn tvn_loop[2];
+  PlanColumn tvn_end[2];
+  PlanColumn alpha[2];
+  PlanColumn np[2];
+  PlanColumn std_np[2];
+  // Shared lookups for the per-policy scalars
+  const std::unordered_map<int, std::shared_ptr<CodeTable>>* code_map = nullptr;
+  const ExpenseGrid* expense_grid = nullptr;
+};
+
+int ParseIndex(const std::wstring& s) {
+  try {
+    return std::stoi(s);
+  } catch (...) {
+    return -1;
+  }
+}
+
+// Index named by the last token of the i-th index spec, or -1 if it has none.
+int IndexAt(const std::vector<std::vector<std::wstring>>& specs, size_t i) {
+  return specs.size() > i && !specs[i].empty() ? ParseIndex(specs[i].back()) : -1;
+}
+
+PlanColumn ResolveColumn(const TableData* table, int index) {
+  if (!table || index < 0) {
+    return PlanColumn();
+  }
+  return PlanColumn{table->Column(static_cast<size_t>(index))};
+}
+
+// Appends the table inputs of one policy with nn periods to each arena of
+// outputs. Only the periods the tVn table has rows for are gathered.
+void GatherInputs(const OutputPlan& plan, int nn, InsuranceOutputBatch& outputs) {
+  size_t tvn_rows = plan.tvn_table ? plan.tvn_table->size() : 0;
+  size_t rows = std::min(static_cast<size_t>(std::max(nn, 0)), tvn_rows);
+  bool has_last = nn > 0 && static_cast<size_t>(nn) <= tvn_rows;
+
+  for (int side = 0; side < 2; ++side) {
+    PolicyArena& tvn = outputs.tVn_Input[side];
+    for (size_t kk = 0; plan.has_tvn && kk < rows; ++kk) {
+      tvn.Push(plan.tvn_loop[side].At(kk));
+    }
+    if (plan.has_tvn_end && has_last) {
+      tvn.Push(plan.tvn_end[side].At(nn - 1));
+    }
+    tvn.EndPolicy();
+  }
+
+  if (rows > 0 && plan.has_alpha) {
+    outputs.Alpha_ALD_Input.Push(plan.alpha[0].At(0));
+    outputs.Alpha_ALD_Input.Push(plan.alpha[1].At(0));
+  }
+  outputs.Alpha_ALD_Input.EndPolicy();
+
+  if (rows > 0 && plan.has_np) {
+    outputs.NP_beta_Input.Push(plan.np[0].At(0));
+    outputs.NP_beta_Input.Push(plan.np[1].At(0));
+  }
+  outputs.NP_beta_Input.EndPolicy();
+
+  if (rows > 0 && plan.has_std_np) {
+    size_t std_np_rows = std::min(rows, plan.std_np_table->size());
+    for (size_t kk = 0; kk < std_np_rows; ++kk) {
+      outputs.STD_NP_Input.Push(plan.std_np[0].At(kk));
+      outputs.STD_NP_Input.Push(plan.std_np[1].At(kk));
+    }
+  }
+  outputs.STD_NP_Input.EndPolicy();
+}
+
+// Builds the outputs of policies [begin, end) of results into outputs,
+// scalar columns first and then the inputs policy by policy.
+void BuildOutputs(const OutputPlan& plan, const InsuranceResultBatch& results, size_t begin, size_t end,
+                  InsuranceOutputBatch& outputs) {
+  size_t count = end - begin;
+  outputs.Resize(count);
+
+  const int* nn = results.nn.data() + begin;
+  for (size_t i = 0; i < count; ++i) {
+    outputs.am[i] = std::min(nn[i], 20);
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    int bojong = results.bojong[begin + i];
+    int mm = results.mm[begin + i];
+
+    // Get dnum from code_map using bojong
+    auto code_it = plan.code_map->find(bojong);
+    if (code_it == plan.code_map->end()) {
+      Abort(L"bojong %d not found in code_map\n", bojong);
+    }
+    int dnum = code_it->second->dnum;
+
+    // Get alp and beta values from the expense grid using dnum and mm
+    const ExpenseRates* expense_rates = plan.expense_grid->Find(dnum, mm);
+    if (!expense_rates) {
+      if (!plan.expense_grid->HasDnum(dnum)) {
+        Abort(L"dnum %d not found in expense_table_map\n", dnum);
+      }
+      Abort(L"mm value %d not found in expense_vector for dnum %d\n", mm, dnum);
+    }
+    outputs.alp[i] = expense_rates->alp;
+    outputs.beta1[i] = expense_rates->beta1;
+    outputs.beta2[i] = expense_rates->beta2;
+    outputs.beta3[i] = expense_rates->beta3;
+    outputs.gamma[i] = expense_rates->gamma;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    GatherInputs(plan, nn[i], outputs);
+  }
+}
+
+}  // namespace
+
 void InsuranceOutputDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   auto& insurance_output_context = std::any_cast<InsuranceOutputContext&>(context);
   try {
@@ -34,27 +177,27 @@ void InsuranceOutputDataStructure::ConstructDataStructure(std::any& context, con
     std::shared_ptr<DataHelper> data_helper = GetDataHelper();
 
     // 1. Get Table Data Context
-    auto* table_context_ptr = data_helper->GetDataContext(key);
+    auto* table_context_ptr = data_helper->GetDataContext(SymbolTable::Intern(key));
     if (!table_context_ptr) {
       Abort(L"Failed to get TableData context\n");
     }
     const auto& table_data_map = std::any_cast<const TableDataStructure::TableDataMap&>(*table_context_ptr);
 
     // 2. Get Insurance Result Data Context
-    auto* insurance_context_ptr = data_helper->GetDataContext(L"InsuranceResult");
+    auto* insurance_context_ptr = data_helper->GetDataContext(Symbols::kInsuranceResult);
     if (!insurance_context_ptr) {
       Abort(L"Failed to get InsuranceResult context\n");
     }
-    const auto& insurance_results = std::any_cast<const InsuranceResultDataStructure::InsuranceResultList&>(*insurance_context_ptr);
+    const auto& insurance_results = std::any_cast<const InsuranceResultBatch&>(*insurance_context_ptr);
 
-    // Get Expense Output Data Context
-    std::shared_ptr<ExpenseOutput> expense_output = nullptr;
-    auto* expense_output_context_ptr = data_helper->GetDataContext(L"ExpenseOutput");
+    // Get the expense grid built after the Expense sheet was read
+    std::shared_ptr<const ExpenseGrid> expense_grid;
+    auto* expense_output_context_ptr = data_helper->GetDataContext(Symbols::kExpenseOutput);
     if (expense_output_context_ptr) {
       const auto& expense_output_ctx = std::any_cast<const ExpenseOutputContext&>(*expense_output_context_ptr);
-      expense_output = expense_output_ctx.output;
+      expense_grid = expense_output_ctx.grid;
     } else {
-      Logger::Log(L"Warning: Failed to get ExpenseOutput context\n");
+      LOG_WARN(L"Warning: Failed to get ExpenseOutput context\n");
     }
 
     // 3. Get the specific table data for the key
@@ -63,39 +206,26 @@ void InsuranceOutputDataStructure::ConstructDataStructure(std::any& context, con
       Abort(L"Table data not found for key: %ls\n", key.c_str());
     }
 
-    auto expense_context_ptr = data_helper->GetDataContext(L"Expense");
-    if (!expense_context_ptr) {
-      Abort(L"Failed to get Expense context\n");
+    // Without an ExpenseOutput grid, build one from the Expense context for this run
+    if (!expense_grid) {
+      auto expense_context_ptr = data_helper->GetDataContext(Symbols::kExpense);
+      if (!expense_context_ptr) {
+        Abort(L"Failed to get Expense context\n");
+      }
+      const auto& expense_table_map = std::any_cast<const ExpenseDataStructure::ExpenseTableMap&>(*expense_context_ptr);
+      expense_grid = std::make_shared<const ExpenseGrid>(ExpenseDataStructure::BuildGrid(expense_table_map));
     }
-    const auto& expense_table_map = std::any_cast<const ExpenseDataStructure::ExpenseTableMap&>(*expense_context_ptr);
 
-    auto code_context_ptr = data_helper->GetDataContext(L"Code");
+    auto code_context_ptr = data_helper->GetDataContext(Symbols::kCode);
     if (!code_context_ptr) {
       Abort(L"Failed to get Code context\n");
     }
     const auto& code_context = std::any_cast<const CodeDataContext&>(*code_context_ptr);
     const auto& code_map = code_context.code_table;
 
-    // Helper lambda to parse index from string safely
-    auto parse_index = [](const std::wstring& s) -> int {
-      try {
-        return std::stoi(s);
-      } catch (...) {
-        return -1;
-      }
-    };
-
-    // Helper lambda to get value from row safely
-    auto get_value = [&](const std::vector<int>& row, int idx) -> double {
-      if (idx >= 0 && idx < static_cast<int>(row.size())) {
-        return static_cast<double>(row[idx]);
-      }
-      return 0.0;
-    };
-
-    // Helper lambda to get table row from a given table name and row index
-    auto get_table_row = [&](const std::wstring& table_name, int row_idx) -> const std::vector<int>* {
-      auto* ctx_ptr = data_helper->GetDataContext(table_name);
+    // Helper lambda to get a table by name
+    auto get_table = [&](const std::wstring& table_name) -> const TableData* {
+      auto* ctx_ptr = data_helper->GetDataContext(SymbolTable::Intern(table_name));
       if (!ctx_ptr) {
         Abort(L"Failed to get TableData context for %ls\n", table_name.c_str());
       }
@@ -104,194 +234,120 @@ void InsuranceOutputDataStructure::ConstructDataStructure(std::any& context, con
       if (it == map.end()) {
         Abort(L"Table data not found for key: %ls\n", table_name.c_str());
       }
-      if (row_idx < 0 || row_idx >= static_cast<int>(it->second.size())) {
-        return nullptr;
-      }
-      return &(it->second[row_idx]);
+      return &it->second;
     };
 
-    // Process each insurance_result separately
-    for (const auto& insurance_result : insurance_results) {
-      // Create a new output_ptr for each insurance_result
-      std::shared_ptr<InsuranceOutput> output_ptr = std::make_shared<InsuranceOutput>();
-      output_ptr->tVn_Input.resize(2);
-
-      // Extract indices from InsuranceOutputIndex
-      int idx_tVn_1_loop = -1, idx_tVn_1_end = -1;
-      int idx_tVn_2_loop = -1, idx_tVn_2_end = -1;
-      int idx_NP_1 = -1, idx_NP_2 = -1;
-      int idx_Alpha_1 = -1, idx_Alpha_2 = -1;
-      int idx_STD_NP_1 = -1, idx_STD_NP_2 = -1;
-      int nn = insurance_result->nn, mm = insurance_result->mm, bojong = insurance_result->bojong;
-
-      // Get dnum from code_map using bojong
-      int dnum = 0;
-      auto code_it = code_map.find(bojong);
-      dnum = code_it->second->dnum;
-
-      if (insurance_output_index.tVn_Input.second.size() > 0 && !insurance_output_index.tVn_Input.second[0].empty()) {
-        idx_tVn_1_loop = parse_index(insurance_output_index.tVn_Input.second[0].back());
-        idx_tVn_1_end = idx_tVn_1_loop + 1;
-      }
-
-      if (insurance_output_index.tVn_Input.second.size() > 1 && !insurance_output_index.tVn_Input.second[1].empty()) {
-        idx_tVn_2_loop = parse_index(insurance_output_index.tVn_Input.second[1].back());
-        idx_tVn_2_end = idx_tVn_2_loop + 1;
-      }
-
-      if (insurance_output_index.NP_beta_Input.second.size() > 0 && !insurance_output_index.NP_beta_Input.second[0].empty()) {
-        idx_NP_1 = parse_index(insurance_output_index.NP_beta_Input.second[0].back());
-      }
-      if (insurance_output_index.NP_beta_Input.second.size() > 1 && !insurance_output_index.NP_beta_Input.second[1].empty()) {
-        idx_NP_2 = parse_index(insurance_output_index.NP_beta_Input.second[1].back());
-      }
-
-      if (insurance_output_index.Alpha_ALD_Input.second.size() > 0 && !insurance_output_index.Alpha_ALD_Input.second[0].empty()) {
-        idx_Alpha_1 = parse_index(insurance_output_index.Alpha_ALD_Input.second[0].back());
-      }
-      if (insurance_output_index.Alpha_ALD_Input.second.size() > 1 && !insurance_output_index.Alpha_ALD_Input.second[1].empty()) {
-        idx_Alpha_2 = parse_index(insurance_output_index.Alpha_ALD_Input.second[1].back());
-      }
-
-      if (insurance_output_index.STD_NP_Input.second.size() > 0 && !insurance_output_index.STD_NP_Input.second[0].empty()) {
-        idx_STD_NP_1 = parse_index(insurance_output_index.STD_NP_Input.second[0].back());
-      }
-      if (insurance_output_index.STD_NP_Input.second.size() > 1 && !insurance_output_index.STD_NP_Input.second[1].empty()) {
-        idx_STD_NP_2 = parse_index(insurance_output_index.STD_NP_Input.second[1].back());
-      }
-
-      // Loop kk = 0 to nn - 1 for this specific insurance_result
-      for (int kk = 0; kk < nn; ++kk) {
-        // Get row from tVn_Input table
-        const auto* row = get_table_row(insurance_output_index.tVn_Input.first, kk);
-        if (!row) {
-          continue;
-        }
-
-        if (idx_tVn_1_loop != -1) {
-          output_ptr->tVn_Input[0].push_back(get_value(*row, idx_tVn_1_loop));
-          output_ptr->tVn_Input[1].push_back(get_value(*row, idx_tVn_2_loop));
-        }
-
-        if (kk == 0) {
-          if (idx_Alpha_1 != -1) {
-            output_ptr->Alpha_ALD_Input.push_back(get_value(*row, idx_Alpha_1));
-            output_ptr->Alpha_ALD_Input.push_back(get_value(*row, idx_Alpha_2));
-          }
-          if (idx_NP_1 != -1) {
-            output_ptr->NP_beta_Input.push_back(get_value(*row, idx_NP_1));
-            output_ptr->NP_beta_Input.push_back(get_value(*row, idx_NP_2));
-          }
-        }
-
-        // Get row from STD_NP_Input table
-        const auto* std_row = get_table_row(insurance_output_index.STD_NP_Input.first, kk);
-        if (std_row && idx_STD_NP_1 != -1) {
-          output_ptr->STD_NP_Input.push_back(get_value(*std_row, idx_STD_NP_1));
-          output_ptr->STD_NP_Input.push_back(get_value(*std_row, idx_STD_NP_2));
-        }
-
-        if (kk == nn - 1 && idx_tVn_1_end != -1) {
-          output_ptr->tVn_Input[0].push_back(get_value(*row, idx_tVn_1_end));
-          output_ptr->tVn_Input[1].push_back(get_value(*row, idx_tVn_2_end));
-        }
-      }
-
-      // Get alp and beta values from expense_table_map using dnum and mm
-      auto expense_it = expense_table_map.find(dnum);
-      if (expense_it != expense_table_map.end()) {
-        const auto& expense_vector = expense_it->second;
-        bool found = false;
-
-        // Loop through expense_vector to find matching mm
-        for (const auto& expense_item : expense_vector) {
-          if (expense_item->mm == mm) {
-            output_ptr->alp = expense_item->ap;
-            output_ptr->beta1 = expense_item->bp;
-            output_ptr->beta2 = expense_item->bs;
-            output_ptr->beta3 = expense_item->b2;
-            output_ptr->gamma = expense_item->bo;
-            found = true;
-            break;
-          }
-        }
-
-        if (!found) {
-          Abort(L"mm value %d not found in expense_vector for dnum %d\n", mm, dnum);
-        }
-      } else {
-        Abort(L"dnum %d not found in expense_table_map\n", dnum);
+    // 4. Compile the output plan: parse the column indices and resolve the
+    // tables once for every policy. Tables are only needed (and must only
+    // exist) if some policy has periods to gather.
+    OutputPlan plan;
+    int alpha_1 = IndexAt(insurance_output_index.Alpha_ALD_Input.second, 0);
+    int alpha_2 = IndexAt(insurance_output_index.Alpha_ALD_Input.second, 1);
+    int np_1 = IndexAt(insurance_output_index.NP_beta_Input.second, 0);
+    int np_2 = IndexAt(insurance_output_index.NP_beta_Input.second, 1);
+    int std_np_1 = IndexAt(insurance_output_index.STD_NP_Input.second, 0);
+    int std_np_2 = IndexAt(insurance_output_index.STD_NP_Input.second, 1);
+    const auto& tvn_specs = insurance_output_index.tVn_Input.second;
+    int tvn_1 = IndexAt(tvn_specs, 0);
+    int tvn_2 = IndexAt(tvn_specs, 1);
+    bool has_tvn_1 = tvn_specs.size() > 0 && !tvn_specs[0].empty();
+    bool has_tvn_2 = tvn_specs.size() > 1 && !tvn_specs[1].empty();
+    bool any_periods = std::any_of(insurance_results.nn.begin(), insurance_results.nn.end(), [](int nn) { return nn > 0; });
+    if (any_periods) {
+      plan.tvn_table = get_table(insurance_output_index.tVn_Input.first);
+      if (!plan.tvn_table->empty()) {
+        plan.std_np_table = get_table(insurance_output_index.STD_NP_Input.first);
       }
-
-      output_ptr->am = std::min(nn, 20);
-
-      // Add this completed output_ptr to the context
-      insurance_output_context.output.push_back(output_ptr);
     }
-
-    Logger::Log(L"Constructing InsuranceOutputDataStructure with key: %ls\n", key.c_str());
+    plan.has_tvn = tvn_1 != -1;
+    plan.has_tvn_end = has_tvn_1 && tvn_1 + 1 != -1;
+    plan.has_alpha = alpha_1 != -1;
+    plan.has_np = np_1 != -1;
+    plan.has_std_np = std_np_1 != -1 && plan.std_np_table;
+    plan.tvn_loop[0] = ResolveColumn(plan.tvn_table, tvn_1);
+    plan.tvn_loop[1] = ResolveColumn(plan.tvn_table, tvn_2);
+    plan.tvn_end[0] = ResolveColumn(plan.tvn_table, has_tvn_1 ? tvn_1 + 1 : -1);
+    plan.tvn_end[1] = ResolveColumn(plan.tvn_table, has_tvn_2 ? tvn_2 + 1 : -1);
+    plan.alpha[0] = ResolveColumn(plan.tvn_table, alpha_1);
+    plan.alpha[1] = ResolveColumn(plan.tvn_table, alpha_2);
+    plan.np[0] = ResolveColumn(plan.tvn_table, np_1);
+    plan.np[1] = ResolveColumn(plan.tvn_table, np_2);
+    plan.std_np[0] = ResolveColumn(plan.std_np_table, std_np_1);
+    plan.std_np[1] = ResolveColumn(plan.std_np_table, std_np_2);
+
+    plan.code_map = &code_map;
+    plan.expense_grid = expense_grid.get();
+
+    // 5. Build the outputs in policy chunks on the pool. Each chunk has its
+    // own columns and arenas, appended in policy order so the order is kept.
+    InsuranceOutputBatch outputs = ParallelReduce(
+        IndexRange{0, insurance_results.size()}, kPolicyGrain, InsuranceOutputBatch(),
+        [&plan, &insurance_results](IndexRange policies) {
+          InsuranceOutputBatch chunk;
+          BuildOutputs(plan, insurance_results, policies.begin, policies.end, chunk);
+          return chunk;
+        },
+        [](InsuranceOutputBatch&& left, InsuranceOutputBatch&& right) {
+          left.Append(std::move(right));
+          return std::move(left);
+        },
+        DataHelper::WorkerPool());
+    insurance_output_context.output.Append(std::move(outputs));
+
+    LOG_INFO(L"Constructing InsuranceOutputDataStructure with key: %ls\n", key.c_str());
   } catch (const std::exception& e) {
-    Logger::Log(L"Error in InsuranceOutputDataStructure::ConstructDataStructure: %ls\n", Ctw(e.what()).c_str());
+    LOG_ERROR(L"Error in InsuranceOutputDataStructure::ConstructDataStructure: %ls\n", Ctw(e.what()).c_str());
+  }
+}
+
+// InsuranceOutput is derived from the table, InsuranceResult and Expense contexts, not read from sheet rows.
+void InsuranceOutputDataStructure::ConstructFromRows(std::any& /*context*/, const CellRowSpan& rows, const std::wstring& key) {
+  if (rows.size() > 0) {
+    LOG_WARN(L"Warning: InsuranceOutputDataStructure does not take row input, ignoring %zu rows for %ls\n", rows.size(), key.c_str());
   }
 }
 
 void InsuranceOutputDataStructure::MergeDataStructure(std::any& target, const std::any& source) {
   auto& target_ctx = std::any_cast<InsuranceOutputContext&>(target);
   const auto& source_ctx = std::any_cast<const InsuranceOutputContext&>(source);
+  target_ctx.output.Append(source_ctx.output);
+}
 
-  if (source_ctx.output.empty()) {
-    return;
-  }
-
-  target_ctx.output.insert(target_ctx.output.end(), source_ctx.output.begin(), source_ctx.output.end());
+void InsuranceOutputDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  auto& target_ctx = std::any_cast<InsuranceOutputContext&>(target);
+  target_ctx.output.Append(std::move(std::any_cast<InsuranceOutputContext&>(source).output));
 }
 
 void InsuranceOutputDataStructure::PrintDataStructure(const std::any& context) const {
   const auto& insurance_context = std::any_cast<const InsuranceOutputContext&>(context);
-  if (insurance_context.output.empty()) {
-    Logger::Log(L"InsuranceOutputDataStructure is empty.\n");
+  const InsuranceOutputBatch& output = insurance_context.output;
+  if (output.size() == 0) {
+    LOG_DEBUG(L"InsuranceOutputDataStructure is empty.\n");
     return;
   }
-  // const auto& output = insurance_context.output;
-
-  Logger::Log(L"InsuranceOutputDataStructure contents:\n");
-
-  for (const auto& iter : insurance_context.output) {
-    Logger::Log(L"  alp: %.2f\n", iter->alp);
-    Logger::Log(L"  beta1: %.2f\n", iter->beta1);
-    Logger::Log(L"  beta2: %.2f\n", iter->beta2);
-    Logger::Log(L"  beta3: %.2f\n", iter->beta3);
-    Logger::Log(L"  gamma: %.2f\n", iter->gamma);
-    Logger::Log(L"  am: %d\n", iter->am);
-
-    Logger::Log(L"  tVn_Input (Row 0): ");
-    for (double val : iter->tVn_Input[0]) {
-      Logger::Log(L"%.2f ", val);
-    }
-    Logger::Log(L"\n");
 
-    Logger::Log(L"  tVn_Input (Row 1): ");
-    for (double val : iter->tVn_Input[1]) {
-      Logger::Log(L"%.2f ", val);
-    }
-    Logger::Log(L"\n");
-
-    Logger::Log(L"  Alpha_ALD_Input: ");
-    for (double val : iter->Alpha_ALD_Input) {
-      Logger::Log(L"%.2f ", val);
-    }
-    Logger::Log(L"\n");
-
-    Logger::Log(L"  NP_beta_Input: ");
-    for (double val : iter->NP_beta_Input) {
-      Logger::Log(L"%.2f ", val);
-    }
-    Logger::Log(L"\n");
+  LOG_DEBUG(L"InsuranceOutputDataStructure contents:\n");
 
-    Logger::Log(L"  STD_NP_Input: ");
-    for (double val : iter->STD_NP_Input) {
-      Logger::Log(L"%.2f ", val);
+  auto log_values = [](const wchar_t* label, PolicyValues values) {
+    LOG_DEBUG(label);
+    for (double val : values) {
+      LOG_DEBUG(L"%.2f ", val);
     }
-    Logger::Log(L"\n");
+    LOG_DEBUG(L"\n");
+  };
+
+  for (size_t policy = 0; policy < output.size(); ++policy) {
+    LOG_DEBUG(L"  alp: %.2f\n", output.alp[policy]);
+    LOG_DEBUG(L"  beta1: %.2f\n", output.beta1[policy]);
+    LOG_DEBUG(L"  beta2: %.2f\n", output.beta2[policy]);
+    LOG_DEBUG(L"  beta3: %.2f\n", output.beta3[policy]);
+    LOG_DEBUG(L"  gamma: %.2f\n", output.gamma[policy]);
+    LOG_DEBUG(L"  am: %d\n", output.am[policy]);
+
+    log_values(L"  tVn_Input (Row 0): ", output.tVn_Input[0][policy]);
+    log_values(L"  tVn_Input (Row 1): ", output.tVn_Input[1][policy]);
+    log_values(L"  Alpha_ALD_Input: ", output.Alpha_ALD_Input[policy]);
+    log_values(L"  NP_beta_Input: ", output.NP_beta_Input[policy]);
+    log_values(L"  STD_NP_Input: ", output.STD_NP_Input[policy]);
   }
 }
@@ -20,27 +20,15 @@
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
+#include "DataProcessor/policy_batch.h"
 struct InsuranceOutputIndex {
   std::pair<std::wstring, std::vector<std::vector<std::wstring>>> tVn_Input;
   std::pair<std::wstring, std::vector<std::vector<std::wstring>>> Alpha_ALD_Input;
   std::pair<std::wstring, std::vector<std::vector<std::wstring>>> NP_beta_Input;
   std::pair<std::wstring, std::vector<std::vector<std::wstring>>> STD_NP_Input;
 };
-struct InsuranceOutput {
-  double alp;
-  double beta1;
-  double beta2;
-  double beta3;
-  double gamma;
-  int am;
-  std::vector<std::vector<double>> tVn_Input;
-  std::vector<double> Alpha_ALD_Input;
-  std::vector<double> NP_beta_Input;
-  std::vector<double> STD_NP_Input;
-};
-
 struct InsuranceOutputContext {
-  std::vector<std::shared_ptr<InsuranceOutput>> output;
+  InsuranceOutputBatch output;
 };
 
 class InsuranceOutputDataStructure : public IDataStructure {
@@ -50,7 +38,10 @@ class InsuranceOutputDataStructure : public IDataStructure {
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
   std::any CreateContext() const override { return InsuranceOutputContext(); }
 };
@@ -13,10 +13,12 @@
 // ============================================================================
 #include "DataProcessor/insurance_result_data_structure.h"
 
+#include <algorithm>
 #include <any>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "DataProcessor/code_data_structure.h"
@@ -25,14 +27,66 @@
 #include "Logger/logger.h"
 #include "Utility/abort.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
+#include "Utility/parallel.h"
 
 // Assuming these types based on usage in the project
 using TableDataMap = TableDataStructure::TableDataMap;
 // using CodeDataMap = std::unordered_map<int, std::shared_ptr<CodeData>>; // Removed incorrect alias
 
-void InsuranceResultDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
-  auto& insurance_result = std::any_cast<InsuranceResultList&>(context);
+namespace {
+
+// Fewest table rows a chunk turns into results.
+constexpr size_t kRowGrain = 1024;
+
+// Appends a result for each of rows [begin, end) of table to results.
+void BuildResults(const TableData& table, size_t begin, size_t end, const InsuranceResultIndex& result_index,
+                  const std::unordered_map<int, std::shared_ptr<CodeTable>>& code_map, InsuranceResultBatch& results) {
+  constexpr int kGpInputSize = InsuranceResultBatch::kGpInputSize;
+  size_t base = results.size();
+  size_t count = end - begin;
+  results.Resize(base + count);
+
+  // Map fields using result_index, a column at a time
+  for (auto [column, index] : {std::pair{&results.bojong, result_index.bojong}, std::pair{&results.nn, result_index.nn},
+                               std::pair{&results.mm, result_index.mm}, std::pair{&results.x, result_index.x},
+                               std::pair{&results.AMT, result_index.AMT}}) {
+    if (index < 0) {
+      continue;
+    }
+    TableColumnView source = table.Column(static_cast<size_t>(index));
+    int* target = column->data() + base;
+    for (size_t i = 0; i < count; ++i) {
+      target[i] = source[begin + i];
+    }
+  }
+
+  // Map GP_Input
+  if (!result_index.GP_Input.empty() && result_index.GP_Input[0].size() >= 3) {
+    int r = result_index.GP_Input[0][0];
+    int c = result_index.GP_Input[0][1];
+    int val_idx = result_index.GP_Input[0][2];
+
+    if (r >= 0 && r < kGpInputSize && c >= 0 && c < kGpInputSize && val_idx >= 0) {
+      for (size_t i = 0; i < count; ++i) {
+        TableRowView row = table.Row(begin + i);
+        if (val_idx < static_cast<int>(row.size())) {
+          results.GP_Input[base + i][r][c] = row[val_idx];
+        }
+      }
+    }
+  }
+
+  // Map dnum from CodeData
+  for (size_t i = base; i < base + count; ++i) {
+    auto code_it = code_map.find(results.bojong[i]);
+    results.dnum[i] = code_it != code_map.end() ? code_it->second->dnum : 0;
+  }
+}
+
+}  // namespace
 
+void InsuranceResultDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   try {
     if (args.empty()) {
       Abort(L"Arguments empty for InsuranceResultDataStructure\n");
@@ -48,13 +102,13 @@ void InsuranceResultDataStructure::ConstructDataStructure(std::any& context, con
     }
 
     // Get Table Data Context
-    std::any* table_data_any = data_helper->GetDataContext(key);
+    std::any* table_data_any = data_helper->GetDataContext(SymbolTable::Intern(key));
     if (!table_data_any) {
       Abort(L"Table data context not found for key: %ls\n", key.c_str());
     }
 
     // Get Code Data Context
-    std::any* code_data_any = data_helper->GetDataContext(L"Code");
+    std::any* code_data_any = data_helper->GetDataContext(Symbols::kCode);
     if (!code_data_any) {
       Abort(L"Code data context not found\n");
     }
@@ -64,70 +118,79 @@ void InsuranceResultDataStructure::ConstructDataStructure(std::any& context, con
     const auto& code_context = std::any_cast<const CodeDataContext&>(*code_data_any);
     const auto& code_map = code_context.code_table;
 
-    for (const auto& iter1 : table_data) {
-      for (const auto& iter2 : iter1.second) {
-        std::shared_ptr<InsuranceResult> result = std::make_shared<InsuranceResult>();
-        result->GP_Input.resize(10, std::vector<int>(10, 0));
-        // Map fields using result_index
-        result->bojong = iter2[result_index->bojong];
-        result->nn = iter2[result_index->nn];
-        result->mm = iter2[result_index->mm];
-        result->x = iter2[result_index->x];
-        result->AMT = iter2[result_index->AMT];
-
-        // Map GP_Input
-        if (!result_index->GP_Input.empty() && result_index->GP_Input[0].size() >= 3) {
-          int r = result_index->GP_Input[0][0];
-          int c = result_index->GP_Input[0][1];
-          int val_idx = result_index->GP_Input[0][2];
-
-          if (r >= 0 && r < 10 && c >= 0 && c < 10 && val_idx >= 0 && val_idx < static_cast<int>(iter2.size())) {
-            result->GP_Input[r][c] = iter2[val_idx];
-          }
-        }
-
-        // Map dnum from CodeData
-        auto code_it = code_map.find(result->bojong);
-        if (code_it != code_map.end()) {
-          result->dnum = code_it->second->dnum;
-        } else {
-          result->dnum = 0;
-        }
-
-        insurance_result.emplace_back(result);
-      }
+    // Rows of every table, in table order, are numbered as one range;
+    // table_begin[i] is the number of the first row of tables[i]
+    std::vector<const TableData*> tables;
+    std::vector<size_t> table_begin;
+    size_t row_count = 0;
+    for (const auto& iter : table_data) {
+      tables.push_back(&iter.second);
+      table_begin.push_back(row_count);
+      row_count += iter.second.size();
     }
 
+    // Each chunk builds its own results, which are appended in row order
+    InsuranceResultBatch results = ParallelReduce(
+        IndexRange{0, row_count}, kRowGrain, InsuranceResultBatch(),
+        [&tables, &table_begin, &result_index, &code_map](IndexRange rows) {
+          InsuranceResultBatch chunk;
+          size_t table = std::upper_bound(table_begin.begin(), table_begin.end(), rows.begin) - table_begin.begin() - 1;
+          for (; table < tables.size() && table_begin[table] < rows.end; ++table) {
+            size_t begin = std::max(rows.begin, table_begin[table]) - table_begin[table];
+            size_t end = std::min(rows.end - table_begin[table], tables[table]->size());
+            BuildResults(*tables[table], begin, end, *result_index, code_map, chunk);
+          }
+          return chunk;
+        },
+        [](InsuranceResultBatch&& left, InsuranceResultBatch&& right) {
+          left.Append(std::move(right));
+          return std::move(left);
+        },
+        DataHelper::WorkerPool());
+    std::any_cast<InsuranceResultBatch&>(context).Append(std::move(results));
   } catch (const std::bad_any_cast& e) {
-    Logger::Log(L"Error: Bad any_cast in ConstructDataStructure: %ls. Check data types.\n", Ctw(e.what()).c_str());
+    LOG_ERROR(L"Error: Bad any_cast in ConstructDataStructure: %ls. Check data types.\n", Ctw(e.what()).c_str());
   } catch (const std::exception& e) {
-    Logger::Log(L"Error in ConstructDataStructure: %ls\n", Ctw(e.what()).c_str());
+    LOG_ERROR(L"Error in ConstructDataStructure: %ls\n", Ctw(e.what()).c_str());
+  }
+}
+
+// InsuranceResult is derived from the table and Code contexts, not read from sheet rows.
+void InsuranceResultDataStructure::ConstructFromRows(std::any& /*context*/, const CellRowSpan& rows, const std::wstring& key) {
+  if (rows.size() > 0) {
+    LOG_WARN(L"Warning: InsuranceResultDataStructure does not take row input, ignoring %zu rows for %ls\n", rows.size(), key.c_str());
   }
 }
 
 void InsuranceResultDataStructure::MergeDataStructure(std::any& target, const std::any& source) {
-  auto& target_list = std::any_cast<InsuranceResultList&>(target);
-  const auto& source_list = std::any_cast<const InsuranceResultList&>(source);
-  target_list.insert(target_list.end(), source_list.begin(), source_list.end());
+  auto& target_batch = std::any_cast<InsuranceResultBatch&>(target);
+  const auto& source_batch = std::any_cast<const InsuranceResultBatch&>(source);
+  target_batch.Append(source_batch);
+}
+
+void InsuranceResultDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  std::any_cast<InsuranceResultBatch&>(target).Append(std::move(std::any_cast<InsuranceResultBatch&>(source)));
 }
 
 void InsuranceResultDataStructure::PrintDataStructure(const std::any& context) const {
   try {
-    const auto& insurance_result = std::any_cast<const InsuranceResultList&>(context);
-    for (const auto& result : insurance_result) {
-      Logger::Log(
+    const auto& insurance_result = std::any_cast<const InsuranceResultBatch&>(context);
+    for (size_t policy = 0; policy < insurance_result.size(); ++policy) {
+      LOG_DEBUG(
           L"InsuranceResult: bojong: %d, dnum: %d, nn: %d, mm: %d, x: %d, AMT: %d\n",
-          result->bojong, result->dnum, result->nn, result->mm, result->x, result->AMT);
-      for (int i = 0; i < 10; ++i) {
-        for (int j = 0; j < 10; ++j) {
-          if (result->GP_Input[i][j] == 0) {
+          insurance_result.bojong[policy], insurance_result.dnum[policy], insurance_result.nn[policy],
+          insurance_result.mm[policy], insurance_result.x[policy], insurance_result.AMT[policy]);
+      const auto& gp_input = insurance_result.GP_Input[policy];
+      for (int i = 0; i < InsuranceResultBatch::kGpInputSize; ++i) {
+        for (int j = 0; j < InsuranceResultBatch::kGpInputSize; ++j) {
+          if (gp_input[i][j] == 0) {
             continue;
           }
-          Logger::Log(L"GP_Input[%d][%d]: %d\n", i, j, result->GP_Input[i][j]);
+          LOG_DEBUG(L"GP_Input[%d][%d]: %d\n", i, j, gp_input[i][j]);
         }
       }
     }
   } catch (const std::exception& e) {
-    Logger::Log(L"Error in PrintDataStructure: %ls\n", Ctw(e.what()).c_str());
+    LOG_ERROR(L"Error in PrintDataStructure: %ls\n", Ctw(e.what()).c_str());
   }
 }
@@ -20,15 +20,7 @@
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
-struct InsuranceResult {
-  int bojong;
-  int nn;
-  int mm;
-  int x;
-  int AMT;
-  int dnum;
-  std::vector<std::vector<int>> GP_Input;
-};
+#include "DataProcessor/policy_batch.h"
 struct InsuranceResultIndex {
   int bojong;
   int nn;
@@ -39,15 +31,16 @@ struct InsuranceResultIndex {
 };
 class InsuranceResultDataStructure : public IDataStructure {
  public:
-  using InsuranceResultList = std::vector<std::shared_ptr<InsuranceResult>>;
-
   explicit InsuranceResultDataStructure(std::shared_ptr<DataHelper> data_helper)
       : IDataStructure(data_helper) {}
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
-  std::any CreateContext() const override { return InsuranceResultList(); }
+  std::any CreateContext() const override { return InsuranceResultBatch(); }
 };
 #endif  // SRC_DATAPROCESSOR_INSURANCE_RESULT_DATA_STRUCTURE_H_
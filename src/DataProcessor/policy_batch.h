@@ -0,0 +1,181 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_POLICY_BATCH_H_
+#define SRC_DATAPROCESSOR_POLICY_BATCH_H_
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "Utility/aligned_allocator.h"
+
+// Non-owning view of the values one policy has in a PolicyArena.
+class PolicyValues {
+ public:
+  PolicyValues(const double* data, size_t size) : data_(data), size_(size) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  double operator[](size_t i) const { return data_[i]; }
+  const double* begin() const { return data_; }
+  const double* end() const { return data_ + size_; }
+
+ private:
+  const double* data_;
+  size_t size_;
+};
+
+// Variable-length values of every policy in a batch, stored back to back in
+// one arena. Policy i owns [offsets[i], offsets[i + 1]); values are pushed
+// for the open policy and EndPolicy closes it.
+class PolicyArena {
+ public:
+  size_t size() const { return offsets_.size() - 1; }
+  size_t ValueCount() const { return values_.size(); }
+
+  void Reserve(size_t policies, size_t values) {
+    offsets_.reserve(policies + 1);
+    values_.reserve(values);
+  }
+
+  void Push(double value) { values_.push_back(value); }
+  void EndPolicy() { offsets_.push_back(values_.size()); }
+
+  PolicyValues operator[](size_t policy) const {
+    return PolicyValues(values_.data() + offsets_[policy], offsets_[policy + 1] - offsets_[policy]);
+  }
+
+  // Appends every policy of other, in order.
+  void Append(const PolicyArena& other) {
+    size_t base = values_.size();
+    values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+    offsets_.reserve(offsets_.size() + other.size());
+    for (size_t policy = 1; policy < other.offsets_.size(); ++policy) {
+      offsets_.push_back(base + other.offsets_[policy]);
+    }
+  }
+
+  // Steals other's buffers if this arena is empty; other is left empty.
+  void Append(PolicyArena&& other) {
+    if (size() == 0) {
+      *this = std::move(other);
+      // A moved-from arena has lost its leading offset
+      other = PolicyArena();
+      return;
+    }
+    Append(static_cast<const PolicyArena&>(other));
+  }
+
+ private:
+  AlignedVector<double> values_;
+  std::vector<size_t> offsets_{0};
+};
+
+// InsuranceResult context: one aligned column per field, indexed by policy.
+struct InsuranceResultBatch {
+  static constexpr int kGpInputSize = 10;
+  using GpInput = std::array<std::array<int, kGpInputSize>, kGpInputSize>;
+
+  AlignedVector<int> bojong;
+  AlignedVector<int> nn;
+  AlignedVector<int> mm;
+  AlignedVector<int> x;
+  AlignedVector<int> AMT;
+  AlignedVector<int> dnum;
+  AlignedVector<GpInput> GP_Input;
+
+  size_t size() const { return bojong.size(); }
+
+  // Resizes every column to policies; new policies are zero.
+  void Resize(size_t policies) {
+    for (auto* column : {&bojong, &nn, &mm, &x, &AMT, &dnum}) {
+      column->resize(policies);
+    }
+    GP_Input.resize(policies);
+  }
+
+  // Appends every policy of other, in order.
+  void Append(const InsuranceResultBatch& other) {
+    for (auto [column, source] : {std::pair{&bojong, &other.bojong}, std::pair{&nn, &other.nn},
+                                  std::pair{&mm, &other.mm}, std::pair{&x, &other.x},
+                                  std::pair{&AMT, &other.AMT}, std::pair{&dnum, &other.dnum}}) {
+      column->insert(column->end(), source->begin(), source->end());
+    }
+    GP_Input.insert(GP_Input.end(), other.GP_Input.begin(), other.GP_Input.end());
+  }
+
+  void Append(InsuranceResultBatch&& other) {
+    if (size() == 0) {
+      *this = std::move(other);
+      return;
+    }
+    Append(static_cast<const InsuranceResultBatch&>(other));
+  }
+};
+
+// InsuranceOutput context: the scalar outputs as aligned columns and the
+// per-policy cash-flow inputs in shared arenas, all indexed by policy.
+struct InsuranceOutputBatch {
+  AlignedVector<double> alp;
+  AlignedVector<double> beta1;
+  AlignedVector<double> beta2;
+  AlignedVector<double> beta3;
+  AlignedVector<double> gamma;
+  AlignedVector<int> am;
+  PolicyArena tVn_Input[2];
+  PolicyArena Alpha_ALD_Input;
+  PolicyArena NP_beta_Input;
+  PolicyArena STD_NP_Input;
+
+  size_t size() const { return am.size(); }
+
+  // Resizes the scalar columns to policies; the arenas are filled policy by
+  // policy with EndPolicy.
+  void Resize(size_t policies) {
+    for (auto* column : {&alp, &beta1, &beta2, &beta3, &gamma}) {
+      column->resize(policies);
+    }
+    am.resize(policies);
+  }
+
+  // Appends every policy of other, in order.
+  void Append(const InsuranceOutputBatch& other) {
+    for (auto [column, source] : {std::pair{&alp, &other.alp}, std::pair{&beta1, &other.beta1},
+                                  std::pair{&beta2, &other.beta2}, std::pair{&beta3, &other.beta3},
+                                  std::pair{&gamma, &other.gamma}}) {
+      column->insert(column->end(), source->begin(), source->end());
+    }
+    am.insert(am.end(), other.am.begin(), other.am.end());
+    for (int side = 0; side < 2; ++side) {
+      tVn_Input[side].Append(other.tVn_Input[side]);
+    }
+    Alpha_ALD_Input.Append(other.Alpha_ALD_Input);
+    NP_beta_Input.Append(other.NP_beta_Input);
+    STD_NP_Input.Append(other.STD_NP_Input);
+  }
+
+  // Steals other's buffers if this batch is empty; other is left empty.
+  void Append(InsuranceOutputBatch&& other) {
+    if (size() == 0) {
+      *this = std::move(other);
+      // Resets the moved-from arenas along with the columns
+      other = InsuranceOutputBatch();
+      return;
+    }
+    Append(static_cast<const InsuranceOutputBatch&>(other));
+  }
+};
+
+#endif  // SRC_DATAPROCESSOR_POLICY_BATCH_H_
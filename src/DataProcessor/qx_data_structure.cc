@@ -14,94 +14,136 @@
 #include "DataProcessor/qx_data_structure.h"
 
 #include <any>
-#include <memory>
-#include <unordered_map>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
 #include "DataProcessor/excel_columns.h"
 #include "Logger/logger.h"
+#include "Utility/symbol_table.h"
 void QxDataStructure::ConstructDataStructure(std::any& context,
                                              const std::vector<std::any>& args,
                                              std::wstring& key) {
-  auto& qx_table = std::any_cast<QxTableMap&>(context);
-  std::wstring input = std::any_cast<std::wstring>(args[0]);
+  auto& qx_store = std::any_cast<QxStore&>(context);
+  const auto& input = std::any_cast<const CellValue&>(args[0]);
   int column = std::any_cast<int>(args[1]);
-  std::wstring key_to_string = L"";
   if (column == QxColumns::FIRST_COLUMN) {
-    key = input;
+    key = input.ToWString();
     return;
   }
-  auto toInt = [](const std::wstring& str) -> int { return std::stoi(str); };
-  auto toDouble = [](const std::wstring& str) -> float {
-    return std::stod(str);
-  };
-  auto& current_qx_table = qx_table[key];
-  std::shared_ptr<QxTable> new_qx_table;
+
+  // Cells arrive one at a time: RISK_CLASS starts a row and FEMALE completes
+  // it. The row is only appended then, so a half-built row is never indexed.
+  Symbol table = SymbolTable::Intern(key);
+  std::optional<QxRow>& pending = qx_store.PendingRow();
+  if (column == QxColumns::RISK_CLASS) {
+    pending.emplace();
+  } else if (column == QxColumns::QX_NAME) {
+    // Follows FEMALE, so it names the row already appended
+    qx_store.SetLastQxName(table, SymbolTable::Intern(input.ToWString()));
+    return;
+  }
+  if (!pending || !SetField(*pending, column, input)) {
+    return;
+  }
+  if (column == QxColumns::FEMALE) {
+    qx_store.AppendRow(table, *pending);
+    pending.reset();
+  }
+}
+
+void QxDataStructure::ConstructFromRows(std::any& context, const CellRowSpan& rows, const std::wstring& /*key*/) {
+  auto& qx_store = std::any_cast<QxStore&>(context);
+  for (const auto& row : rows) {
+    QxRow qx_row;
+    bool has_data = false;
+    for (int column = QxColumns::FIRST_COLUMN + 1; column <= row.LastColumn(); ++column) {
+      const CellValue& input = row.Cell(column);
+      if (!input.IsEmpty()) {
+        has_data |= SetField(qx_row, column, input);
+      }
+    }
+    // Only rows that carry data create an entry for their key
+    if (has_data) {
+      qx_store.AppendRow(SymbolTable::Intern(row.Cell(QxColumns::FIRST_COLUMN).ToWString()), qx_row);
+    }
+  }
+}
+
+bool QxDataStructure::SetField(QxRow& row, int column, const CellValue& input) {
+  auto toInt = [](const CellValue& value) -> int { return static_cast<int>(value.AsInt()); };
+  auto toDouble = [](const CellValue& value) -> double { return value.AsDouble(); };
   switch (column) {
     case QxColumns::RISK_CLASS:
-      new_qx_table = std::make_shared<QxTable>();
-      current_qx_table.emplace_back(new_qx_table);
-      current_qx_table.back()->risk_class = toInt(input);
+      row.risk_class = toInt(input);
       break;
     case QxColumns::DRIVER:
-      current_qx_table.back()->driver = toInt(input);
+      row.driver = toInt(input);
       break;
     case QxColumns::SUB1:
-      current_qx_table.back()->sub1 = toInt(input);
+      row.sub1 = toInt(input);
       break;
     case QxColumns::SUB2:
-      current_qx_table.back()->sub2 = toInt(input);
+      row.sub2 = toInt(input);
       break;
     case QxColumns::SUB3:
-      current_qx_table.back()->sub3 = toInt(input);
+      row.sub3 = toInt(input);
       break;
     case QxColumns::SUB4:
-      current_qx_table.back()->sub4 = toInt(input);
+      row.sub4 = toInt(input);
       break;
     case QxColumns::AGE:
-      current_qx_table.back()->age = toInt(input);
+      row.age = toInt(input);
       break;
     case QxColumns::MALE:
-      current_qx_table.back()->male = toDouble(input);
+      row.male = toDouble(input);
       break;
     case QxColumns::FEMALE:
-      current_qx_table.back()->female = toDouble(input);
+      row.female = toDouble(input);
       break;
     case QxColumns::QX_NAME:
-      current_qx_table.back()->qx_name = input;
+      row.qx_name = SymbolTable::Intern(input.ToWString());
       break;
     default:
-      break;
+      return false;
   }
+  return true;
 }
 
 void QxDataStructure::MergeDataStructure(std::any& target, const std::any& source) {
-  auto& target_map = std::any_cast<QxTableMap&>(target);
-  const auto& source_map = std::any_cast<const QxTableMap&>(source);
+  std::any_cast<QxStore&>(target).Append(std::any_cast<const QxStore&>(source));
+}
 
-  for (const auto& [key, val] : source_map) {
-    auto& target_vec = target_map[key];
-    target_vec.insert(target_vec.end(), val.begin(), val.end());
-  }
+void QxDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  std::any_cast<QxStore&>(target).Append(std::move(std::any_cast<QxStore&>(source)));
 }
 
 void QxDataStructure::PrintDataStructure(const std::any& context) const {
-  const auto& qx_table = std::any_cast<const QxTableMap&>(context);
-  for (const auto& entry : qx_table) {
-    std::wstring qx_name = entry.first;
-    auto current_qx_table = entry.second;
-    Logger::Log(L"Qx name: %ls\n", qx_name.c_str());
-    for (const auto& iter : current_qx_table) {
-      Logger::Log(L"  risk_class: %d", iter->risk_class);
-      Logger::Log(L" driver: %d", iter->driver);
-      Logger::Log(L" sub1: %d", iter->sub1);
-      Logger::Log(L" sub2: %d", iter->sub2);
-      Logger::Log(L" sub3: %d", iter->sub3);
-      Logger::Log(L" sub4: %d", iter->sub4);
-      Logger::Log(L" age: %d", iter->age);
-      Logger::Log(L" male: %lf", iter->male);
-      Logger::Log(L" female: %lf", iter->female);
-      Logger::Log(L" qx_name: %ls\n", iter->qx_name.c_str());
+  const auto& qx_store = std::any_cast<const QxStore&>(context);
+  for (const auto& [table, rows] : qx_store.Tables()) {
+    LOG_DEBUG(L"Qx name: %ls\n", table.Name().c_str());
+    for (size_t i = 0; i < rows.size(); ++i) {
+      LOG_DEBUG(L"  risk_class: %d", rows.risk_class[i]);
+      LOG_DEBUG(L" driver: %d", rows.driver[i]);
+      LOG_DEBUG(L" sub1: %d", rows.sub1[i]);
+      LOG_DEBUG(L" sub2: %d", rows.sub2[i]);
+      LOG_DEBUG(L" sub3: %d", rows.sub3[i]);
+      LOG_DEBUG(L" sub4: %d", rows.sub4[i]);
+      LOG_DEBUG(L" age: %d", rows.age[i]);
+      LOG_DEBUG(L" male: %lf", rows.male[i]);
+      LOG_DEBUG(L" female: %lf", rows.female[i]);
+      LOG_DEBUG(L" qx_name: %ls\n", rows.qx_name[i].IsValid() ? rows.qx_name[i].Name().c_str() : L"");
     }
   }
 }
+
+bool QxDataStructure::SaveContext(const std::any& context, SnapshotWriter& out) const {
+  std::any_cast<const QxStore&>(context).Save(out);
+  return true;
+}
+
+bool QxDataStructure::LoadContext(SnapshotReader& in, std::any& context) const {
+  return std::any_cast<QxStore&>(context).Load(in);
+}
@@ -16,35 +16,30 @@
 #include <any>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
-struct QxTable {
-  int risk_class;
-  int driver;
-  int sub1;
-  int sub2;
-  int sub3;
-  int sub4;
-  int age;
-  double male;
-  double female;
-  std::wstring qx_name;
-};
+#include "DataProcessor/qx_store.h"
 class QxDataStructure : public IDataStructure {
  public:
-  using QxTableMap =
-      std::unordered_map<std::wstring, std::vector<std::shared_ptr<QxTable>>>;
-
   explicit QxDataStructure(std::shared_ptr<DataHelper> data_helper)
       : IDataStructure(data_helper) {}
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
-  std::any CreateContext() const override { return QxTableMap(); }
+  std::any CreateContext() const override { return QxStore(); }
+  bool SaveContext(const std::any& context, SnapshotWriter& out) const override;
+  bool LoadContext(SnapshotReader& in, std::any& context) const override;
+
+ private:
+  // Stores input, the cell of column, in row. Returns false for columns
+  // that are not part of a Qx row.
+  static bool SetField(QxRow& row, int column, const CellValue& input);
 };
 
 #endif  // SRC_DATAPROCESSOR_QX_DATA_STRUCTURE_H_
@@ -0,0 +1,334 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_QX_STORE_H_
+#define SRC_DATAPROCESSOR_QX_STORE_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DataProcessor/snapshot.h"
+#include "Logger/logger.h"
+#include "Utility/symbol_table.h"
+
+enum class QxSex {
+  MALE = 0,
+  FEMALE = 1
+};
+
+// One row of a Qx sheet.
+struct QxRow {
+  int risk_class = 0;
+  int driver = 0;
+  int sub1 = 0;
+  int sub2 = 0;
+  int sub3 = 0;
+  int sub4 = 0;
+  int age = 0;
+  double male = 0.0;
+  double female = 0.0;
+  Symbol qx_name;
+};
+
+// Everything that selects one mortality curve; the age picks the point on it.
+struct QxCurveKey {
+  Symbol table;
+  int risk_class = 0;
+  int driver = 0;
+  int sub1 = 0;
+  int sub2 = 0;
+  int sub3 = 0;
+  int sub4 = 0;
+
+  bool operator==(const QxCurveKey& other) const {
+    return table == other.table && risk_class == other.risk_class && driver == other.driver && sub1 == other.sub1 &&
+           sub2 == other.sub2 && sub3 == other.sub3 && sub4 == other.sub4;
+  }
+};
+
+struct QxCurveKeyHash {
+  size_t operator()(const QxCurveKey& key) const {
+    uint64_t hash = key.table.Id();
+    for (int part : {key.risk_class, key.driver, key.sub1, key.sub2, key.sub3, key.sub4}) {
+      hash = (hash ^ static_cast<uint32_t>(part)) * 0x100000001B3ULL;
+    }
+    return static_cast<size_t>(hash ^ (hash >> 32));
+  }
+};
+
+// Rates of one curve by age: one contiguous array per sex, starting at
+// MinAge(). Ages with no row read as NaN.
+class QxCurve {
+ public:
+  static constexpr double kMissing = std::numeric_limits<double>::quiet_NaN();
+
+  bool empty() const { return rates_[0].empty(); }
+  size_t size() const { return rates_[0].size(); }
+  int MinAge() const { return min_age_; }
+  int MaxAge() const { return min_age_ + static_cast<int>(size()) - 1; }
+
+  bool Has(int age) const { return age >= min_age_ && age <= MaxAge() && source_row_[age - min_age_] != kNoRow; }
+
+  // qx at age, or NaN.
+  double Qx(int age, QxSex sex) const {
+    return age >= min_age_ && age <= MaxAge() ? rates_[static_cast<int>(sex)][age - min_age_] : kMissing;
+  }
+
+  // Rates()[i] is qx at MinAge() + i, for size() ages.
+  const double* Rates(QxSex sex) const { return rates_[static_cast<int>(sex)].data(); }
+
+  // Sets the rates at age; row is the store row they came from.
+  void Set(int age, double male, double female, uint32_t row) {
+    if (empty()) {
+      min_age_ = age;
+    } else if (age < min_age_) {
+      size_t shift = static_cast<size_t>(min_age_ - age);
+      for (auto& rates : rates_) {
+        rates.insert(rates.begin(), shift, kMissing);
+      }
+      source_row_.insert(source_row_.begin(), shift, kNoRow);
+      min_age_ = age;
+    }
+    size_t index = static_cast<size_t>(age - min_age_);
+    if (index >= size()) {
+      for (auto& rates : rates_) {
+        rates.resize(index + 1, kMissing);
+      }
+      source_row_.resize(index + 1, kNoRow);
+    }
+    rates_[0][index] = male;
+    rates_[1][index] = female;
+    source_row_[index] = row;
+  }
+
+  // Span (MaxAge() - MinAge() + 1) the curve would have with age added.
+  int64_t SpanWith(int age) const {
+    if (empty()) {
+      return 1;
+    }
+    int64_t low = std::min<int64_t>(min_age_, age);
+    int64_t high = std::max<int64_t>(MaxAge(), age);
+    return high - low + 1;
+  }
+
+ private:
+  static constexpr uint32_t kNoRow = UINT32_MAX;
+
+  int min_age_ = 0;
+  std::vector<double> rates_[2];
+  std::vector<uint32_t> source_row_;
+};
+
+// Rows of one Qx table (one value of the sheet's key column), column by
+// column in sheet order.
+struct QxTableRows {
+  std::vector<int> risk_class;
+  std::vector<int> driver;
+  std::vector<int> sub1;
+  std::vector<int> sub2;
+  std::vector<int> sub3;
+  std::vector<int> sub4;
+  std::vector<int> age;
+  std::vector<double> male;
+  std::vector<double> female;
+  std::vector<Symbol> qx_name;
+
+  size_t size() const { return age.size(); }
+
+  QxRow Row(size_t i) const {
+    return QxRow{risk_class[i], driver[i], sub1[i], sub2[i], sub3[i], sub4[i], age[i], male[i], female[i], qx_name[i]};
+  }
+
+  void Push(const QxRow& row) {
+    risk_class.push_back(row.risk_class);
+    driver.push_back(row.driver);
+    sub1.push_back(row.sub1);
+    sub2.push_back(row.sub2);
+    sub3.push_back(row.sub3);
+    sub4.push_back(row.sub4);
+    age.push_back(row.age);
+    male.push_back(row.male);
+    female.push_back(row.female);
+    qx_name.push_back(row.qx_name);
+  }
+};
+
+// Qx context: every table's rows plus a curve per composite key, so that
+// qx(age) is one hash lookup for the curve and an array index for the age.
+// When two rows give the same key and age, the later row wins.
+class QxStore {
+ public:
+  using TableMap = std::unordered_map<Symbol, QxTableRows>;
+
+  // Curves wider than this many ages are not indexed (the rows are kept).
+  static constexpr int64_t kMaxCurveAges = 1 << 16;
+
+  const TableMap& Tables() const { return tables_; }
+  size_t CurveCount() const { return curves_.size(); }
+
+  // Curve of key, or nullptr. Valid until the store is next modified.
+  const QxCurve* FindCurve(const QxCurveKey& key) const {
+    auto it = index_.find(key);
+    return it != index_.end() ? &curves_[it->second] : nullptr;
+  }
+
+  // qx for (key, age, sex), or NaN if no row gives it.
+  double Qx(const QxCurveKey& key, int age, QxSex sex) const {
+    const QxCurve* curve = FindCurve(key);
+    return curve ? curve->Qx(age, sex) : QxCurve::kMissing;
+  }
+
+  void AppendRow(Symbol table, const QxRow& row) {
+    QxTableRows& rows = tables_[table];
+    rows.Push(row);
+    Index(table, row, static_cast<uint32_t>(rows.size() - 1));
+  }
+
+  // Names the last row appended to table. The name is not part of the
+  // curve key, so the index is left as it is. Returns false if table has no rows.
+  bool SetLastQxName(Symbol table, Symbol qx_name) {
+    auto it = tables_.find(table);
+    if (it == tables_.end() || it->second.size() == 0) {
+      return false;
+    }
+    it->second.qx_name.back() = qx_name;
+    return true;
+  }
+
+  // Row being filled cell by cell. It is appended, and so indexed, only once
+  // complete; until then it is not part of the store and is not copied,
+  // merged or saved with it.
+  std::optional<QxRow>& PendingRow() { return pending_row_; }
+
+  // Appends every row of other, table by table in row order.
+  void Append(const QxStore& other) {
+    for (const auto& [table, rows] : other.tables_) {
+      for (size_t i = 0; i < rows.size(); ++i) {
+        AppendRow(table, rows.Row(i));
+      }
+    }
+  }
+
+  // Appends every row of other, taking over its columns where this store
+  // has no rows for a table yet.
+  void Append(QxStore&& other) {
+    if (tables_.empty()) {
+      *this = std::move(other);
+      return;
+    }
+    for (auto& [table, rows] : other.tables_) {
+      auto [it, inserted] = tables_.try_emplace(table);
+      if (!inserted) {
+        for (size_t i = 0; i < rows.size(); ++i) {
+          AppendRow(table, rows.Row(i));
+        }
+        continue;
+      }
+      it->second = std::move(rows);
+      for (size_t i = 0; i < it->second.size(); ++i) {
+        Index(table, it->second.Row(i), static_cast<uint32_t>(i));
+      }
+    }
+  }
+
+  // Snapshot encoding: the columns of each table are written in bulk and
+  // the index is rebuilt on load.
+  void Save(SnapshotWriter& out) const {
+    out.Put<uint64_t>(tables_.size());
+    for (const auto& [table, rows] : tables_) {
+      out.PutString(table.Name());
+      out.PutVector(rows.risk_class);
+      out.PutVector(rows.driver);
+      out.PutVector(rows.sub1);
+      out.PutVector(rows.sub2);
+      out.PutVector(rows.sub3);
+      out.PutVector(rows.sub4);
+      out.PutVector(rows.age);
+      out.PutVector(rows.male);
+      out.PutVector(rows.female);
+      for (Symbol qx_name : rows.qx_name) {
+        out.PutString(qx_name.IsValid() ? qx_name.Name() : std::wstring());
+      }
+    }
+  }
+
+  bool Load(SnapshotReader& in) {
+    uint64_t count = 0;
+    if (!in.GetCount(count)) {
+      return false;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+      std::wstring name;
+      QxTableRows rows;
+      if (!in.GetString(name) || !in.GetVector(rows.risk_class) || !in.GetVector(rows.driver) ||
+          !in.GetVector(rows.sub1) || !in.GetVector(rows.sub2) || !in.GetVector(rows.sub3) ||
+          !in.GetVector(rows.sub4) || !in.GetVector(rows.age) || !in.GetVector(rows.male) ||
+          !in.GetVector(rows.female)) {
+        return false;
+      }
+      size_t row_count = rows.age.size();
+      for (const auto* column : {&rows.risk_class, &rows.driver, &rows.sub1, &rows.sub2, &rows.sub3, &rows.sub4}) {
+        if (column->size() != row_count) {
+          return false;
+        }
+      }
+      if (rows.male.size() != row_count || rows.female.size() != row_count) {
+        return false;
+      }
+      rows.qx_name.reserve(row_count);
+      for (size_t row = 0; row < row_count; ++row) {
+        std::wstring qx_name;
+        if (!in.GetString(qx_name)) {
+          return false;
+        }
+        rows.qx_name.push_back(SymbolTable::Intern(qx_name));
+      }
+      Symbol table = SymbolTable::Intern(name);
+      for (size_t row = 0; row < row_count; ++row) {
+        AppendRow(table, rows.Row(row));
+      }
+    }
+    return true;
+  }
+
+ private:
+  static QxCurveKey KeyOf(Symbol table, const QxRow& row) {
+    return QxCurveKey{table, row.risk_class, row.driver, row.sub1, row.sub2, row.sub3, row.sub4};
+  }
+
+  void Index(Symbol table, const QxRow& row, uint32_t source_row) {
+    auto [it, inserted] = index_.try_emplace(KeyOf(table, row), static_cast<uint32_t>(curves_.size()));
+    if (inserted) {
+      curves_.emplace_back();
+    }
+    QxCurve& curve = curves_[it->second];
+    if (curve.SpanWith(row.age) > kMaxCurveAges) {
+      LOG_WARN(L"Warning: Qx age %d of %ls is out of range, not indexed\n", row.age, table.Name().c_str());
+      return;
+    }
+    curve.Set(row.age, row.male, row.female, source_row);
+  }
+
+  TableMap tables_;
+  std::vector<QxCurve> curves_;
+  std::unordered_map<QxCurveKey, uint32_t, QxCurveKeyHash> index_;
+  std::optional<QxRow> pending_row_;
+};
+
+#endif  // SRC_DATAPROCESSOR_QX_STORE_H_
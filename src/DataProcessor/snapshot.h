@@ -0,0 +1,164 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_SNAPSHOT_H_
+#define SRC_DATAPROCESSOR_SNAPSHOT_H_
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "Utility/mapped_file.h"
+
+// Binary encoding of built contexts for the snapshot cache.
+// Values are stored in native byte order and layout; a snapshot is only
+// read back by the same build, which the header version guards.
+class SnapshotWriter {
+ public:
+  template <typename T>
+  void Put(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Put takes trivially copyable values");
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void PutString(const std::wstring& value) {
+    Put<uint64_t>(value.size());
+    buffer_.append(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(wchar_t));
+  }
+
+  template <typename T>
+  void PutVector(const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>, "PutVector takes trivially copyable values");
+    Put<uint64_t>(values.size());
+    buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  }
+
+  const std::string& Buffer() const { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+// Bounds-checked reader over a snapshot buffer (typically a memory map).
+// Every getter returns false instead of reading past the end.
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(std::string_view data) : data_(data) {}
+
+  template <typename T>
+  bool Get(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Get takes trivially copyable values");
+    if (data_.size() - pos_ < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool GetString(std::wstring& value) {
+    uint64_t size = 0;
+    if (!Get(size) || (data_.size() - pos_) / sizeof(wchar_t) < size) {
+      return false;
+    }
+    value.resize(size);
+    std::memcpy(value.data(), data_.data() + pos_, size * sizeof(wchar_t));
+    pos_ += size * sizeof(wchar_t);
+    return true;
+  }
+
+  template <typename T>
+  bool GetVector(std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>, "GetVector takes trivially copyable values");
+    uint64_t size = 0;
+    if (!Get(size) || (data_.size() - pos_) / sizeof(T) < size) {
+      return false;
+    }
+    values.resize(size);
+    if (size > 0) {
+      std::memcpy(values.data(), data_.data() + pos_, size * sizeof(T));
+    }
+    pos_ += size * sizeof(T);
+    return true;
+  }
+
+  // Element count, rejected if it could not possibly fit in the remaining bytes.
+  bool GetCount(uint64_t& count) { return Get(count) && count <= data_.size() - pos_; }
+
+  bool AtEnd() const { return pos_ == data_.size(); }
+
+ private:
+  std::string_view data_;
+  size_t pos_ = 0;
+};
+
+class Snapshot {
+ public:
+  // Bumped whenever any context encoding, or how cells are converted into
+  // it, changes.
+  static constexpr uint32_t kVersion = 4;
+  static constexpr uint32_t kMagic = 0x50534B4C;  // "LKSP"
+
+  // 64-bit content hash, 8 bytes per step. Not cryptographic: it only has to
+  // notice that an input file changed between runs.
+  static uint64_t Hash(std::string_view data, uint64_t seed = 0x9E3779B97F4A7C15ULL) {
+    constexpr uint64_t kMul = 0xFF51AFD7ED558CCDULL;
+    uint64_t hash = seed ^ (data.size() * kMul);
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+      uint64_t word;
+      std::memcpy(&word, data.data() + i, 8);
+      hash = (hash ^ Mix(word)) * kMul;
+    }
+    uint64_t tail = 0;
+    if (i < data.size()) {
+      std::memcpy(&tail, data.data() + i, data.size() - i);
+    }
+    hash = (hash ^ Mix(tail)) * kMul;
+    return Mix(hash);
+  }
+
+  // Content hash of a whole file. Returns false if it cannot be read.
+  static bool HashFile(const std::string& path, uint64_t& hash) {
+    MappedFile file(path);
+    if (!file.IsOpen()) {
+      return false;
+    }
+    hash = Hash(file.View());
+    return true;
+  }
+
+  // Cache key of one context: the source content hash plus what was read from it.
+  static std::string Key(uint64_t content_hash, const std::wstring& name, const std::wstring& type,
+                         const std::wstring& range) {
+    std::wstring parts = name + L'\x1F' + type + L'\x1F' + range;
+    uint64_t key = Hash(std::string_view(reinterpret_cast<const char*>(parts.data()), parts.size() * sizeof(wchar_t)),
+                        content_hash);
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+    return hex;
+  }
+
+ private:
+  static uint64_t Mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+  }
+};
+
+#endif  // SRC_DATAPROCESSOR_SNAPSHOT_H_
@@ -14,32 +14,57 @@
 #include "DataProcessor/sratio_data_structure.h"
 
 #include <any>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
+#include "DataProcessor/data_helper.h"
 #include "Logger/logger.h"
 void SRatioDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   auto& sratio_table = std::any_cast<SRatioTableMap&>(context);
-  std::wstring input = std::any_cast<std::wstring>(args[0]);
+  const auto& input = std::any_cast<const CellValue&>(args[0]);
   int column = std::any_cast<int>(args[1]);
-  int key_to_int{0};
   if (column == 1) {
-    key = input;
+    key = input.ToWString();
     return;
   }
-  auto toInt = [](const std::wstring& str) -> int { return std::stoi(str); };
-  auto toDouble = [](const std::wstring& str) -> float {
-    return std::stod(str);
-  };
-  key_to_int = toInt(key);
-  auto& current_sratio_table = sratio_table[key_to_int];
-  std::shared_ptr<SRatioTable> new_sratio_table;
+  SetField(GetDataHelper()->ContextArena(), sratio_table[std::stoi(key)], column, input);
+}
+
+void SRatioDataStructure::ConstructFromRows(std::any& context, const CellRowSpan& rows, const std::wstring& /*key*/) {
+  auto& sratio_table = std::any_cast<SRatioTableMap&>(context);
+  BumpArena& arena = GetDataHelper()->ContextArena();
+  for (const auto& row : rows) {
+    const CellValue& key_cell = row.Cell(1);
+    if (key_cell.IsEmpty()) {
+      continue;
+    }
+    int key_to_int = static_cast<int>(key_cell.AsInt());
+    std::vector<std::shared_ptr<SRatioTable>>* current_sratio_table = nullptr;
+    for (int column = 2; column <= row.LastColumn(); ++column) {
+      const CellValue& input = row.Cell(column);
+      if (input.IsEmpty()) {
+        continue;
+      }
+      // Only rows that carry data create an entry for their key
+      if (!current_sratio_table) {
+        current_sratio_table = &sratio_table[key_to_int];
+      }
+      SetField(arena, *current_sratio_table, column, input);
+    }
+  }
+}
+
+void SRatioDataStructure::SetField(BumpArena& arena, std::vector<std::shared_ptr<SRatioTable>>& current_sratio_table, int column, const CellValue& input) {
+  auto toInt = [](const CellValue& value) -> int { return static_cast<int>(value.AsInt()); };
+  auto toDouble = [](const CellValue& value) -> double { return value.AsDouble(); };
   switch (column) {
     case 2:
-      new_sratio_table = std::make_shared<SRatioTable>();
-      current_sratio_table.emplace_back(new_sratio_table);
-      current_sratio_table.back()->name = input;
+      current_sratio_table.emplace_back(arena.MakeShared<SRatioTable>());
+      current_sratio_table.back()->name = input.ToWString();
       break;
     case 3:
       current_sratio_table.back()->standard_price = toDouble(input);
@@ -84,7 +109,7 @@ void SRatioDataStructure::ConstructDataStructure(std::any& context, const std::v
       current_sratio_table.back()->standard_alpha = toDouble(input);
       break;
     case 21:
-      if (input == L"미초과") {
+      if (input.AsString() == u8"미초과") {
         current_sratio_table.back()->reverse = false;
       } else {
         current_sratio_table.back()->reverse = true;
@@ -105,29 +130,109 @@ void SRatioDataStructure::MergeDataStructure(std::any& target, const std::any& s
   }
 }
 
+void SRatioDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  auto& target_map = std::any_cast<SRatioTableMap&>(target);
+  auto& source_map = std::any_cast<SRatioTableMap&>(source);
+
+  // Keys new to target move over as whole map nodes; the records of shared
+  // keys are moved onto the end of target's list
+  for (auto it = source_map.begin(); it != source_map.end();) {
+    auto target_it = target_map.find(it->first);
+    if (target_it == target_map.end()) {
+      target_map.insert(source_map.extract(it++));
+      continue;
+    }
+    auto& target_vec = target_it->second;
+    target_vec.insert(target_vec.end(), std::make_move_iterator(it->second.begin()),
+                      std::make_move_iterator(it->second.end()));
+    ++it;
+  }
+}
+
 void SRatioDataStructure::PrintDataStructure(const std::any& context) const {
   const auto& sratio_table = std::any_cast<const SRatioTableMap&>(context);
   for (const auto& entry : sratio_table) {
     int dnum = entry.first;
     auto current_sratio_table = entry.second;
-    Logger::Log(L"sratio dnum: %d\n", dnum);
+    LOG_DEBUG(L"sratio dnum: %d\n", dnum);
     for (const auto& iter : current_sratio_table) {
-      Logger::Log(L"  name: %ls", iter->name.c_str());
-      Logger::Log(L" standard_price: %lf", iter->standard_price);
-      Logger::Log(L" renewal: %d", iter->renewal);
-      Logger::Log(L" sex: %d", iter->sex);
-      Logger::Log(L" age: %d", iter->age);
-      Logger::Log(L" category: %d", iter->category);
-      Logger::Log(L" real_category: %d", iter->real_category);
-      Logger::Log(L" due: %d", iter->due);
-      Logger::Log(L" real_due: %d", iter->real_due);
-      Logger::Log(L" adjust: %lf", iter->adjust);
-      Logger::Log(L" regular: %lf", iter->regular);
-      Logger::Log(L" sratio: %lf", iter->sratio);
-      Logger::Log(L" min_s: %lf", iter->min_s);
-      Logger::Log(L" apply_alpha: %lf", iter->apply_alpha);
-      Logger::Log(L" standard_alpha: %lf", iter->standard_alpha);
-      Logger::Log(L" reverse: %d\n", iter->reverse);
+      LOG_DEBUG(L"  name: %ls", iter->name.c_str());
+      LOG_DEBUG(L" standard_price: %lf", iter->standard_price);
+      LOG_DEBUG(L" renewal: %d", iter->renewal);
+      LOG_DEBUG(L" sex: %d", iter->sex);
+      LOG_DEBUG(L" age: %d", iter->age);
+      LOG_DEBUG(L" category: %d", iter->category);
+      LOG_DEBUG(L" real_category: %d", iter->real_category);
+      LOG_DEBUG(L" due: %d", iter->due);
+      LOG_DEBUG(L" real_due: %d", iter->real_due);
+      LOG_DEBUG(L" adjust: %lf", iter->adjust);
+      LOG_DEBUG(L" regular: %lf", iter->regular);
+      LOG_DEBUG(L" sratio: %lf", iter->sratio);
+      LOG_DEBUG(L" min_s: %lf", iter->min_s);
+      LOG_DEBUG(L" apply_alpha: %lf", iter->apply_alpha);
+      LOG_DEBUG(L" standard_alpha: %lf", iter->standard_alpha);
+      LOG_DEBUG(L" reverse: %d\n", iter->reverse);
+    }
+  }
+}
+
+bool SRatioDataStructure::SaveContext(const std::any& context, SnapshotWriter& out) const {
+  const auto& sratio_map = std::any_cast<const SRatioTableMap&>(context);
+  out.Put<uint64_t>(sratio_map.size());
+  for (const auto& [code, tables] : sratio_map) {
+    out.Put(code);
+    out.Put<uint64_t>(tables.size());
+    for (const auto& table : tables) {
+      if (!table) {
+        return false;
+      }
+      out.PutString(table->name);
+      out.Put(table->standard_price);
+      out.Put(table->renewal);
+      out.Put(table->sex);
+      out.Put(table->age);
+      out.Put(table->category);
+      out.Put(table->real_category);
+      out.Put(table->due);
+      out.Put(table->real_due);
+      out.Put(table->adjust);
+      out.Put(table->regular);
+      out.Put(table->sratio);
+      out.Put(table->min_s);
+      out.Put(table->apply_alpha);
+      out.Put(table->standard_alpha);
+      out.Put(table->reverse);
+    }
+  }
+  return true;
+}
+
+bool SRatioDataStructure::LoadContext(SnapshotReader& in, std::any& context) const {
+  BumpArena& arena = GetDataHelper()->ContextArena();
+  auto& sratio_map = std::any_cast<SRatioTableMap&>(context);
+  uint64_t count = 0;
+  if (!in.GetCount(count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    int code = 0;
+    uint64_t table_count = 0;
+    if (!in.Get(code) || !in.GetCount(table_count)) {
+      return false;
+    }
+    auto& tables = sratio_map[code];
+    tables.reserve(table_count);
+    for (uint64_t j = 0; j < table_count; ++j) {
+      auto table = arena.MakeShared<SRatioTable>();
+      if (!in.GetString(table->name) || !in.Get(table->standard_price) || !in.Get(table->renewal) ||
+          !in.Get(table->sex) || !in.Get(table->age) || !in.Get(table->category) ||
+          !in.Get(table->real_category) || !in.Get(table->due) || !in.Get(table->real_due) ||
+          !in.Get(table->adjust) || !in.Get(table->regular) || !in.Get(table->sratio) || !in.Get(table->min_s) ||
+          !in.Get(table->apply_alpha) || !in.Get(table->standard_alpha) || !in.Get(table->reverse)) {
+        return false;
+      }
+      tables.push_back(std::move(table));
     }
   }
+  return true;
 }
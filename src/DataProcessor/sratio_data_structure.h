@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
+#include "Utility/arena.h"
 struct SRatioTable {
   std::wstring name;
   double standard_price;
@@ -47,9 +48,18 @@ class SRatioDataStructure : public IDataStructure {
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
   std::any CreateContext() const override { return SRatioTableMap(); }
+  bool SaveContext(const std::any& context, SnapshotWriter& out) const override;
+  bool LoadContext(SnapshotReader& in, std::any& context) const override;
+
+ private:
+  static void SetField(BumpArena& arena, std::vector<std::shared_ptr<SRatioTable>>& current_sratio_table,
+                       int column, const CellValue& input);
 };
 
 #endif  // SRC_DATAPROCESSOR_SRATIO_DATA_STRUCTURE_H_
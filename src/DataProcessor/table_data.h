@@ -0,0 +1,211 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_TABLE_DATA_H_
+#define SRC_DATAPROCESSOR_TABLE_DATA_H_
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "DataProcessor/snapshot.h"
+
+// Non-owning view of one table row.
+class TableRowView {
+ public:
+  TableRowView() = default;
+  TableRowView(const int* data, size_t size) : data_(data), size_(size) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  int operator[](size_t i) const { return data_[i]; }
+  const int* begin() const { return data_; }
+  const int* end() const { return data_ + size_; }
+
+ private:
+  const int* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Non-owning view of one column across every row of a table.
+// Rows too short to have the column read as 0.
+class TableColumnView {
+ public:
+  TableColumnView(const int* data, const size_t* offsets, size_t stride, size_t rows, size_t col)
+      : data_(data), offsets_(offsets), stride_(stride), rows_(rows), col_(col) {}
+
+  size_t size() const { return rows_; }
+
+  int operator[](size_t row) const {
+    if (!offsets_) {
+      // Uniform table: fixed stride walk
+      return col_ < stride_ ? data_[row * stride_ + col_] : 0;
+    }
+    size_t begin = offsets_[row];
+    return begin + col_ < offsets_[row + 1] ? data_[begin + col_] : 0;
+  }
+
+ private:
+  const int* data_;
+  const size_t* offsets_;  // nullptr when every row has stride_ values
+  size_t stride_;
+  size_t rows_;
+  size_t col_;
+};
+
+// Rows of integers stored back to back in one buffer.
+// While every row has the same width the table is addressed by a fixed
+// stride; the first row of a different width switches it to a row-offset
+// index, so ragged input is still kept in order.
+class TableData {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TableRowView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = TableRowView;
+
+    const_iterator(const TableData* table, size_t row) : table_(table), row_(row) {}
+    TableRowView operator*() const { return table_->Row(row_); }
+    const_iterator& operator++() {
+      ++row_;
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const { return row_ == other.row_; }
+    bool operator!=(const const_iterator& other) const { return row_ != other.row_; }
+
+   private:
+    const TableData* table_;
+    size_t row_;
+  };
+
+  size_t size() const { return rows_; }
+  bool empty() const { return rows_ == 0; }
+  // Total number of values across all rows.
+  size_t ValueCount() const { return values_.size(); }
+  bool IsUniform() const { return offsets_.empty(); }
+  // Width of every row when IsUniform(), otherwise of the first row.
+  size_t Width() const { return width_; }
+
+  void Reserve(size_t rows, size_t values) {
+    values_.reserve(values);
+    if (!IsUniform()) {
+      offsets_.reserve(rows + 1);
+    }
+  }
+
+  void AppendRow(const int* values, size_t count) {
+    if (rows_ == 0 && values_.empty()) {
+      width_ = count;
+    } else if (IsUniform() && count != width_) {
+      BuildOffsets();
+    }
+    values_.insert(values_.end(), values, values + count);
+    ++rows_;
+    if (!IsUniform()) {
+      offsets_.push_back(values_.size());
+    }
+  }
+
+  void AppendRow(const std::vector<int>& values) { AppendRow(values.data(), values.size()); }
+
+  // Appends every row of other, in order.
+  void Append(const TableData& other) {
+    if (other.empty()) {
+      return;
+    }
+    if (empty()) {
+      *this = other;
+      return;
+    }
+    if (IsUniform() && other.IsUniform() && other.width_ == width_) {
+      values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+      rows_ += other.rows_;
+      return;
+    }
+    for (auto row : other) {
+      AppendRow(row.begin(), row.size());
+    }
+  }
+
+  // Steals other's buffers if this table is empty; other is left empty.
+  void Append(TableData&& other) {
+    if (empty()) {
+      *this = std::move(other);
+      // The move empties the buffers but copies rows_ and width_
+      other = TableData();
+      return;
+    }
+    Append(static_cast<const TableData&>(other));
+  }
+
+  TableRowView Row(size_t row) const {
+    if (IsUniform()) {
+      return TableRowView(values_.data() + row * width_, width_);
+    }
+    return TableRowView(values_.data() + offsets_[row], offsets_[row + 1] - offsets_[row]);
+  }
+  TableRowView operator[](size_t row) const { return Row(row); }
+
+  TableColumnView Column(size_t col) const {
+    return TableColumnView(values_.data(), IsUniform() ? nullptr : offsets_.data(), width_, rows_, col);
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, rows_); }
+
+  // Snapshot encoding: the buffers are written and read back in bulk.
+  void Save(SnapshotWriter& out) const {
+    out.Put<uint64_t>(width_);
+    out.Put<uint64_t>(rows_);
+    out.PutVector(values_);
+    out.PutVector(offsets_);
+  }
+
+  bool Load(SnapshotReader& in) {
+    uint64_t width = 0;
+    uint64_t rows = 0;
+    if (!in.Get(width) || !in.Get(rows) || !in.GetVector(values_) || !in.GetVector(offsets_)) {
+      return false;
+    }
+    width_ = width;
+    rows_ = rows;
+    // Every Row() span has to lie within values_, whatever the file says
+    if (offsets_.empty()) {
+      return (width_ == 0 || rows_ <= values_.size() / width_) && values_.size() == rows_ * width_;
+    }
+    if (offsets_.size() - 1 != rows_ || offsets_.front() != 0 || offsets_.back() != values_.size()) {
+      return false;
+    }
+    return std::is_sorted(offsets_.begin(), offsets_.end());
+  }
+
+ private:
+  // Switches from fixed stride to explicit row offsets.
+  void BuildOffsets() {
+    offsets_.resize(rows_ + 1);
+    for (size_t row = 0; row <= rows_; ++row) {
+      offsets_[row] = row * width_;
+    }
+  }
+
+  std::vector<int> values_;
+  std::vector<size_t> offsets_;  // rows_ + 1 entries once the table is ragged
+  size_t width_ = 0;
+  size_t rows_ = 0;
+};
+
+#endif  // SRC_DATAPROCESSOR_TABLE_DATA_H_
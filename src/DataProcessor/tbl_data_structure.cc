@@ -14,10 +14,20 @@
 #include "DataProcessor/tbl_data_structure.h"
 
 #include <any>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "Logger/logger.h"
+#include "Utility/abort.h"
+#include "Utility/string_utils.h"
+#include "Utility/tbl_scanner.h"
 void TableDataStructure::ConstructDataStructure(std::any& context, const std::vector<std::any>& args, std::wstring& key) {
   auto& table_data_structure = std::any_cast<TableDataMap&>(context);
   std::wstring input = std::any_cast<std::wstring>(args[0]);
@@ -38,7 +48,120 @@ void TableDataStructure::ConstructDataStructure(std::any& context, const std::ve
       break;
     }
   }
-  table_data_structure[key].emplace_back(numbers);
+  table_data_structure[key].AppendRow(numbers);
+}
+
+namespace {
+// Longest digit run taken by the kernel parser; it cannot overflow uint64_t.
+constexpr size_t kMaxFastDigits = 18;
+
+// Aborts on field [begin, field_end), quoting the line it sits on.
+void AbortOnField(const wchar_t* reason, const char* begin, const char* field_end, const char* line_begin,
+                  const char* text_end) {
+  const char* line_end = line_begin;
+  while (line_end < text_end && *line_end != '\n' && *line_end != '\r') {
+    ++line_end;
+  }
+  Abort(L"%ls '%ls' in .tbl line '%ls'\n", reason, Ctw(std::string(begin, field_end)).c_str(),
+        Ctw(std::string(line_begin, line_end)).c_str());
+}
+
+// Fallback for fields the fast path does not take: converted with strtod like
+// the std::stod based path, so exponents, leading '.' and trailing text keep
+// their old meaning, and truncated towards zero.
+int ParseFieldSlow(const char* begin, const char* field_end, const char* line_begin, const char* text_end) {
+  std::string field(begin, field_end);
+  char* parsed_end = nullptr;
+  errno = 0;
+  double value = std::strtod(field.c_str(), &parsed_end);
+  if (parsed_end == field.c_str()) {
+    AbortOnField(L"Invalid number", begin, field_end, line_begin, text_end);
+  }
+  if (errno == ERANGE || !(value > INT_MIN - 1.0 && value < INT_MAX + 1.0)) {
+    AbortOnField(L"Number out of range", begin, field_end, line_begin, text_end);
+  }
+  return static_cast<int>(value);
+}
+
+// Number in the field [begin, field_end) of the line at line_begin. Plain
+// integers, with an optional fraction that is dropped, are parsed with the
+// kernel digit parser; digit runs are parsed against text_end so SIMD loads
+// can span past the field. Other fields take ParseFieldSlow. Aborts if the
+// field is not a number or does not fit an int.
+int ParseField(const char* begin, const char* field_end, const char* line_begin, const char* text_end,
+               const TblScanner::Kernels& kernels) {
+  const char* p = begin;
+  while (p < field_end && *p == ' ') {
+    ++p;
+  }
+  bool negative = false;
+  if (p < field_end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  uint64_t value = 0;
+  const char* digits_end = kernels.parse_digits(p, text_end, &value);
+  size_t digit_count = static_cast<size_t>(digits_end - p);
+  p = digits_end;
+  if (p < field_end && *p == '.') {
+    ++p;
+    while (p < field_end && static_cast<unsigned char>(*p - '0') < 10) {
+      ++p;
+    }
+  }
+  if (digit_count == 0 || digit_count > kMaxFastDigits || p != field_end) {
+    return ParseFieldSlow(begin, field_end, line_begin, text_end);
+  }
+  int64_t signed_value = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+  if (signed_value < INT_MIN || signed_value > INT_MAX) {
+    AbortOnField(L"Number out of range", begin, field_end, line_begin, text_end);
+  }
+  return static_cast<int>(signed_value);
+}
+}  // namespace
+
+void TableDataStructure::ParseRows(std::string_view text, TableData& rows, const TblScanner::Kernels& kernels) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  // Line buffer, reused so parsing allocates only as the table grows
+  std::vector<int> numbers;
+  while (p < end) {
+    const char* line_begin = p;
+    numbers.clear();
+    while (true) {
+      const char* delimiter = kernels.find_delimiter(p, end);
+      // A field exists if it has text, or is empty but followed by a tab
+      if (delimiter > p || (delimiter < end && *delimiter == '\t')) {
+        numbers.push_back(ParseField(p, delimiter, line_begin, end, kernels));
+      }
+      if (delimiter == end) {
+        p = end;
+        break;
+      }
+      if (*delimiter == '\t') {
+        p = delimiter + 1;
+        continue;
+      }
+      // '\n' ends the line; '\r' drops whatever is left of it
+      auto newline = *delimiter == '\n' ? delimiter
+                                        : static_cast<const char*>(std::memchr(delimiter, '\n', end - delimiter));
+      p = newline ? newline + 1 : end;
+      break;
+    }
+    rows.AppendRow(numbers);
+  }
+}
+
+void TableDataStructure::ConstructFromRows(std::any& context, const CellRowSpan& rows, const std::wstring& key) {
+  auto& table_rows = std::any_cast<TableDataMap&>(context)[key];
+  std::vector<int> numbers;
+  for (const auto& row : rows) {
+    numbers.clear();
+    for (const auto& cell : row.cells) {
+      numbers.push_back(static_cast<int>(cell.AsInt()));
+    }
+    table_rows.AppendRow(numbers);
+  }
 }
 
 void TableDataStructure::MergeDataStructure(std::any& target, const std::any& source) {
@@ -46,15 +169,23 @@ void TableDataStructure::MergeDataStructure(std::any& target, const std::any& so
   const auto& source_map = std::any_cast<const TableDataMap&>(source);
 
   for (const auto& [key, val] : source_map) {
-    auto& target_vec = target_map[key];
-    target_vec.insert(target_vec.end(), val.begin(), val.end());
+    target_map[key].Append(val);
+  }
+}
+
+void TableDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  auto& target_map = std::any_cast<TableDataMap&>(target);
+  auto& source_map = std::any_cast<TableDataMap&>(source);
+
+  for (auto& [key, val] : source_map) {
+    target_map[key].Append(std::move(val));
   }
 }
 
 void TableDataStructure::PrintDataStructure(const std::any& context) const {
   const auto& table_data_structure = std::any_cast<const TableDataMap&>(context);
   for (const auto& [key, value] : table_data_structure) {
-    Logger::Log(L"Key: %ls\n", key.c_str());
+    LOG_DEBUG(L"Key: %ls\n", key.c_str());
     if (key == L"67868") {
       printf("Hello world!\n");
     }
@@ -63,7 +194,32 @@ void TableDataStructure::PrintDataStructure(const std::any& context) const {
       for (const auto& num : row) {
         row_str += std::to_wstring(num) + L" ";
       }
-      Logger::Log("%ls\n", row_str.c_str());
+      LOG_DEBUG("%ls\n", row_str.c_str());
+    }
+  }
+}
+
+bool TableDataStructure::SaveContext(const std::any& context, SnapshotWriter& out) const {
+  const auto& table_map = std::any_cast<const TableDataMap&>(context);
+  out.Put<uint64_t>(table_map.size());
+  for (const auto& [key, table] : table_map) {
+    out.PutString(key);
+    table.Save(out);
+  }
+  return true;
+}
+
+bool TableDataStructure::LoadContext(SnapshotReader& in, std::any& context) const {
+  auto& table_map = std::any_cast<TableDataMap&>(context);
+  uint64_t count = 0;
+  if (!in.GetCount(count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    std::wstring key;
+    if (!in.GetString(key) || !table_map[key].Load(in)) {
+      return false;
     }
   }
+  return true;
 }
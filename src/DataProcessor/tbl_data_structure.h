@@ -16,23 +16,39 @@
 #include <any>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
+#include "DataProcessor/table_data.h"
+#include "Utility/tbl_scanner.h"
 class TableDataStructure : public IDataStructure {
  public:
-  using TableDataMap =
-      std::unordered_map<std::wstring, std::vector<std::vector<int>>>;
+  using TableDataMap = std::unordered_map<std::wstring, TableData>;
 
   explicit TableDataStructure(std::shared_ptr<DataHelper> data_helper)
       : IDataStructure(data_helper) {}
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
   std::any CreateContext() const override { return TableDataMap(); }
+  bool SaveContext(const std::any& context, SnapshotWriter& out) const override;
+  bool LoadContext(SnapshotReader& in, std::any& context) const override;
+
+  // Parses tab-separated integer lines straight from a text buffer and
+  // appends one row per line. LF and CRLF endings are both accepted.
+  // Values are converted like the std::stod based path (fractions are
+  // truncated, exponents are honoured); a field that is not a number or
+  // does not fit an int aborts with the offending line.
+  // Delimiters and digit runs are scanned with the given TblScanner kernels.
+  static void ParseRows(std::string_view text, TableData& rows,
+                        const TblScanner::Kernels& kernels = TblScanner::Active());
 };
 
 #endif  // SRC_DATAPROCESSOR_TBL_DATA_STRUCTURE_H_
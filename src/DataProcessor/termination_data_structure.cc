@@ -14,133 +14,85 @@
 #include "DataProcessor/termination_data_structure.h"
 
 #include <any>
-#include <memory>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
 #include "Logger/logger.h"
+
+namespace {
+// Printed label of each duration slot.
+constexpr const wchar_t* kDurationNames[TerminationRates::kDurationCount] = {
+    L"ten", L"eleven", L"twelve", L"thirteen", L"fourteen", L"fifteen", L"sixteen",
+    L"seventeen", L"eighteen", L"nineteen", L"twenty", L"twenty-one", L"twenty-two", L"twenty-three",
+    L"twenty-four", L"twenty-five", L"twenty-six", L"twenty-seven", L"twenty-eight", L"twenty-nine", L"thirty"};
+}  // namespace
+
 void TerminationDataStructure::ConstructDataStructure(
     std::any& context, const std::vector<std::any>& args, std::wstring& key) {
-  auto& termination_table = std::any_cast<TerminationTableMap&>(context);
-  std::wstring input = std::any_cast<std::wstring>(args[0]);
+  auto& termination_rates = std::any_cast<TerminationRates&>(context);
+  const auto& input = std::any_cast<const CellValue&>(args[0]);
   int column = std::any_cast<int>(args[1]);
-  int key_to_int{0};
-  auto toInt = [](const std::wstring& str) -> int { return std::stoi(str); };
-  auto toDouble = [](const std::wstring& str) -> float {
-    return std::stod(str);
-  };
-  if (column == 2) {
-    key = input;
-    key_to_int = toInt(key);
-    termination_table[key_to_int] = std::make_shared<TerminationTable>();
+  if (column == TerminationColumns::KEY) {
+    key = input.ToWString();
+    termination_rates.ResetRow(static_cast<int>(input.AsInt()));
     return;
   }
-  key_to_int = toInt(key);
-  auto& current_termination_table = termination_table[key_to_int];
-  switch (column) {
-    case 3:
-      current_termination_table->ten = toDouble(input);
-      break;
-    case 4:
-      current_termination_table->eleven = toDouble(input);
-      break;
-    case 5:
-      current_termination_table->twelve = toDouble(input);
-      break;
-    case 6:
-      current_termination_table->thirteen = toDouble(input);
-      break;
-    case 7:
-      current_termination_table->fourteen = toDouble(input);
-      break;
-    case 8:
-      current_termination_table->fifteen = toDouble(input);
-      break;
-    case 9:
-      current_termination_table->sixteen = toDouble(input);
-      break;
-    case 10:
-      current_termination_table->seventeen = toDouble(input);
-      break;
-    case 11:
-      current_termination_table->eighteen = toDouble(input);
-      break;
-    case 12:
-      current_termination_table->nineteen = toDouble(input);
-      break;
-    case 13:
-      current_termination_table->twenty = toDouble(input);
-      break;
-    case 14:
-      current_termination_table->twenty_one = toDouble(input);
-      break;
-    case 15:
-      current_termination_table->twenty_two = toDouble(input);
-      break;
-    case 16:
-      current_termination_table->twenty_three = toDouble(input);
-      break;
-    case 17:
-      current_termination_table->twenty_four = toDouble(input);
-      break;
-    case 18:
-      current_termination_table->twenty_five = toDouble(input);
-      break;
-    case 19:
-      current_termination_table->twenty_six = toDouble(input);
-      break;
-    case 20:
-      current_termination_table->twenty_seven = toDouble(input);
-      break;
-    case 21:
-      current_termination_table->twenty_eight = toDouble(input);
-      break;
-    case 22:
-      current_termination_table->twenty_nine = toDouble(input);
-      break;
-    case 23:
-      current_termination_table->thirty = toDouble(input);
-      break;
+  if (double* rates = termination_rates.MutableCurve(std::stoi(key))) {
+    SetField(rates, column, input);
   }
 }
 
-void TerminationDataStructure::MergeDataStructure(std::any& target, const std::any& source) {
-  auto& target_map = std::any_cast<TerminationTableMap&>(target);
-  const auto& source_map = std::any_cast<const TerminationTableMap&>(source);
+void TerminationDataStructure::ConstructFromRows(std::any& context, const CellRowSpan& rows, const std::wstring& /*key*/) {
+  auto& termination_rates = std::any_cast<TerminationRates&>(context);
+  for (const auto& row : rows) {
+    const CellValue& key_cell = row.Cell(TerminationColumns::KEY);
+    if (key_cell.IsEmpty()) {
+      continue;
+    }
+    double* rates = termination_rates.ResetRow(static_cast<int>(key_cell.AsInt()));
+    for (int column = TerminationColumns::FIRST_RATE; column <= row.LastColumn(); ++column) {
+      const CellValue& input = row.Cell(column);
+      if (!input.IsEmpty()) {
+        SetField(rates, column, input);
+      }
+    }
+  }
+}
 
-  for (const auto& [key, val] : source_map) {
-    target_map[key] = val;
+void TerminationDataStructure::SetField(double* rates, int column, const CellValue& input) {
+  if (column < 0 || column > TerminationColumns::LAST_RATE || kSlotOfColumn[column] < 0) {
+    return;
   }
+  rates[kSlotOfColumn[column]] = input.AsDouble();
+}
+
+void TerminationDataStructure::MergeDataStructure(std::any& target, const std::any& source) {
+  std::any_cast<TerminationRates&>(target).Append(std::any_cast<const TerminationRates&>(source));
+}
+
+void TerminationDataStructure::SpliceDataStructure(std::any& target, std::any&& source) {
+  std::any_cast<TerminationRates&>(target).Append(std::move(std::any_cast<TerminationRates&>(source)));
 }
 
 void TerminationDataStructure::PrintDataStructure(const std::any& context) const {
-  const auto& termination_table =
-      std::any_cast<const TerminationTableMap&>(context);
-  for (const auto& entry : termination_table) {
-    int termination_index = entry.first;
-    auto termination_table = entry.second;
-    Logger::Log(L"Termination index : %d\n", termination_index);
-    Logger::Log(L"ten : %lf ", termination_table->ten);
-    Logger::Log(L"eleven : %lf ", termination_table->eleven);
-    Logger::Log(L"twelve : %lf ", termination_table->twelve);
-    Logger::Log(L"thirteen : %lf ", termination_table->thirteen);
-    Logger::Log(L"fourteen : %lf ", termination_table->fourteen);
-    Logger::Log(L"fifteen : %lf ", termination_table->fifteen);
-    Logger::Log(L"sixteen : %lf ", termination_table->sixteen);
-    Logger::Log(L"seventeen : %lf ", termination_table->seventeen);
-    Logger::Log(L"eighteen : %lf ", termination_table->eighteen);
-    Logger::Log(L"nineteen : %lf ", termination_table->nineteen);
-    Logger::Log(L"twenty : %lf ", termination_table->twenty);
-    Logger::Log(L"twenty-one : %lf ", termination_table->twenty_one);
-    Logger::Log(L"twenty-two : %lf ", termination_table->twenty_two);
-    Logger::Log(L"twenty-three : %lf ", termination_table->twenty_three);
-    Logger::Log(L"twenty-four : %lf ", termination_table->twenty_four);
-    Logger::Log(L"twenty-five : %lf ", termination_table->twenty_five);
-    Logger::Log(L"twenty-six : %lf ", termination_table->twenty_six);
-    Logger::Log(L"twenty-seven : %lf ", termination_table->twenty_seven);
-    Logger::Log(L"twenty-eight : %lf ", termination_table->twenty_eight);
-    Logger::Log(L"twenty-nine : %lf ", termination_table->twenty_nine);
-    Logger::Log(L"thirty : %lf \n", termination_table->thirty);
+  const auto& termination_rates = std::any_cast<const TerminationRates&>(context);
+  for (size_t row = 0; row < termination_rates.size(); ++row) {
+    LOG_DEBUG(L"Termination index : %d\n", termination_rates.KeyAt(row));
+    const double* rates = termination_rates.RowAt(row);
+    for (int slot = 0; slot < TerminationRates::kDurationCount; ++slot) {
+      LOG_DEBUG(L"%ls : %lf ", kDurationNames[slot], rates[slot]);
+    }
+    LOG_DEBUG(L"\n");
   }
 }
+
+bool TerminationDataStructure::SaveContext(const std::any& context, SnapshotWriter& out) const {
+  std::any_cast<const TerminationRates&>(context).Save(out);
+  return true;
+}
+
+bool TerminationDataStructure::LoadContext(SnapshotReader& in, std::any& context) const {
+  return std::any_cast<TerminationRates&>(context).Load(in);
+}
@@ -14,47 +14,44 @@
 #ifndef SRC_DATAPROCESSOR_TERMINATION_DATA_STRUCTURE_H_
 #define SRC_DATAPROCESSOR_TERMINATION_DATA_STRUCTURE_H_
 #include <any>
+#include <array>
 #include <memory>
-#include <unordered_map>
+#include <string>
 #include <vector>
 
 #include "DataProcessor/data_processor.h"
-struct TerminationTable {
-  double ten;
-  double eleven;
-  double twelve;
-  double thirteen;
-  double fourteen;
-  double fifteen;
-  double sixteen;
-  double seventeen;
-  double eighteen;
-  double nineteen;
-  double twenty;
-  double twenty_one;
-  double twenty_two;
-  double twenty_three;
-  double twenty_four;
-  double twenty_five;
-  double twenty_six;
-  double twenty_seven;
-  double twenty_eight;
-  double twenty_nine;
-  double thirty;
-};
+#include "DataProcessor/excel_columns.h"
+#include "DataProcessor/termination_rates.h"
 class TerminationDataStructure : public IDataStructure {
  public:
-  using TerminationTableMap =
-      std::unordered_map<int, std::shared_ptr<TerminationTable>>;
-
   explicit TerminationDataStructure(std::shared_ptr<DataHelper> data_helper)
       : IDataStructure(data_helper) {}
   void ConstructDataStructure(std::any& context,
                               const std::vector<std::any>& args,
                               std::wstring& key) override;
+  void ConstructFromRows(std::any& context, const CellRowSpan& rows,
+                         const std::wstring& key) override;
   void MergeDataStructure(std::any& target, const std::any& source) override;
+  void SpliceDataStructure(std::any& target, std::any&& source) override;
   void PrintDataStructure(const std::any& context) const override;
-  std::any CreateContext() const override { return TerminationTableMap(); }
+  std::any CreateContext() const override { return TerminationRates(); }
+  bool SaveContext(const std::any& context, SnapshotWriter& out) const override;
+  bool LoadContext(SnapshotReader& in, std::any& context) const override;
+
+ private:
+  // Duration slot (0 for duration 10) of each sheet column, or -1 for
+  // columns that hold no rate.
+  static constexpr std::array<int, TerminationColumns::LAST_RATE + 1> kSlotOfColumn = [] {
+    std::array<int, TerminationColumns::LAST_RATE + 1> slots{};
+    for (int column = 0; column <= TerminationColumns::LAST_RATE; ++column) {
+      slots[column] = column >= TerminationColumns::FIRST_RATE ? column - TerminationColumns::FIRST_RATE : -1;
+    }
+    return slots;
+  }();
+  static_assert(TerminationColumns::LAST_RATE - TerminationColumns::FIRST_RATE + 1 == TerminationRates::kDurationCount,
+                "every duration needs a column");
+
+  static void SetField(double* rates, int column, const CellValue& input);
 };
 
 #endif  // SRC_DATAPROCESSOR_TERMINATION_DATA_STRUCTURE_H_
@@ -0,0 +1,109 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_DATAPROCESSOR_TERMINATION_RATES_H_
+#define SRC_DATAPROCESSOR_TERMINATION_RATES_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DataProcessor/snapshot.h"
+
+// Termination rates as one dense key x duration matrix: each key owns a
+// contiguous row of kDurationCount rates (durations kFirstDuration and up),
+// found through a key -> row index. Rates that were never set are 0.
+class TerminationRates {
+ public:
+  static constexpr int kFirstDuration = 10;
+  static constexpr int kDurationCount = 21;
+
+  size_t size() const { return keys_.size(); }
+  bool empty() const { return keys_.empty(); }
+
+  // Key and rates of the row-th key, in first-seen order.
+  int KeyAt(size_t row) const { return keys_[row]; }
+  const double* RowAt(size_t row) const { return rates_.data() + row * kDurationCount; }
+
+  // Lapse curve of key (kDurationCount rates), or nullptr if key is absent.
+  const double* Curve(int key) const {
+    auto it = index_.find(key);
+    return it != index_.end() ? RowAt(it->second) : nullptr;
+  }
+
+  double* MutableCurve(int key) {
+    auto it = index_.find(key);
+    return it != index_.end() ? rates_.data() + it->second * kDurationCount : nullptr;
+  }
+
+  // Rate of key at duration, or 0 if either is out of the table.
+  double Rate(int key, int duration) const {
+    const double* curve = Curve(key);
+    int slot = duration - kFirstDuration;
+    return curve && slot >= 0 && slot < kDurationCount ? curve[slot] : 0.0;
+  }
+
+  // Zeroed row for key. A key seen again starts over in its existing row.
+  double* ResetRow(int key) {
+    auto [it, inserted] = index_.try_emplace(key, static_cast<uint32_t>(keys_.size()));
+    if (inserted) {
+      keys_.push_back(key);
+      rates_.resize(rates_.size() + kDurationCount, 0.0);
+    }
+    double* row = rates_.data() + it->second * kDurationCount;
+    std::fill(row, row + kDurationCount, 0.0);
+    return row;
+  }
+
+  // Adds every row of other; its rows replace rows of the same key.
+  void Append(const TerminationRates& other) {
+    for (size_t row = 0; row < other.size(); ++row) {
+      std::copy(other.RowAt(row), other.RowAt(row) + kDurationCount, ResetRow(other.KeyAt(row)));
+    }
+  }
+
+  void Append(TerminationRates&& other) {
+    if (keys_.empty()) {
+      *this = std::move(other);
+      return;
+    }
+    Append(static_cast<const TerminationRates&>(other));
+  }
+
+  void Save(SnapshotWriter& out) const {
+    out.PutVector(keys_);
+    out.PutVector(rates_);
+  }
+
+  bool Load(SnapshotReader& in) {
+    if (!in.GetVector(keys_) || !in.GetVector(rates_) || rates_.size() != keys_.size() * kDurationCount) {
+      return false;
+    }
+    index_.clear();
+    for (size_t row = 0; row < keys_.size(); ++row) {
+      if (!index_.emplace(keys_[row], static_cast<uint32_t>(row)).second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::vector<int> keys_;
+  std::vector<double> rates_;  // keys_.size() * kDurationCount
+  std::unordered_map<int, uint32_t> index_;
+};
+
+#endif  // SRC_DATAPROCESSOR_TERMINATION_RATES_H_
@@ -24,4 +24,24 @@ void GlobalEnvironment::SetCoreType(ExecutionMode type) { core_type_ = type; }
 
 ExecutionMode GlobalEnvironment::GetCoreType() const { return core_type_; }
 
+void GlobalEnvironment::SetReadMode(ReadMode mode) { read_mode_ = mode; }
+
+ReadMode GlobalEnvironment::GetReadMode() const { return read_mode_; }
+
+void GlobalEnvironment::SetMaxInflightBatches(size_t count) { max_inflight_batches_ = count; }
+
+size_t GlobalEnvironment::GetMaxInflightBatches() const { return max_inflight_batches_; }
+
+void GlobalEnvironment::SetSnapshotDir(const std::string& dir) { snapshot_dir_ = dir; }
+
+const std::string& GlobalEnvironment::GetSnapshotDir() const { return snapshot_dir_; }
+
+void GlobalEnvironment::SetWorkerThreads(size_t count) { worker_threads_ = count; }
+
+size_t GlobalEnvironment::GetWorkerThreads() const { return worker_threads_; }
+
+void GlobalEnvironment::SetThreadPlacement(ThreadPlacement placement) { thread_placement_ = placement; }
+
+ThreadPlacement GlobalEnvironment::GetThreadPlacement() const { return thread_placement_; }
+
 }  // namespace Environments
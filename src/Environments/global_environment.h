@@ -13,6 +13,8 @@
 // ============================================================================
 #ifndef SRC_ENVIRONMENTS_GLOBAL_ENVIRONMENT_H_
 #define SRC_ENVIRONMENTS_GLOBAL_ENVIRONMENT_H_
+#include <cstddef>
+#include <string>
 
 namespace Environments {
 
@@ -22,12 +24,39 @@ enum class ExecutionMode {
   CUDA
 };
 
+// How read_excel walks a worksheet
+enum class ReadMode {
+  CELL,   // one wks.cell(ref) lookup per (row, col)
+  STREAM  // single sequential pass over <sheetData>
+};
+
+// Where the thread pool pins its workers
+enum class ThreadPlacement {
+  NONE,     // not pinned; the scheduler decides
+  COMPACT,  // fill one NUMA node's CPUs before the next
+  SPREAD    // deal workers round-robin over the NUMA nodes
+};
+
 class GlobalEnvironment {
  public:
   static GlobalEnvironment& GetInstance();
 
   void SetCoreType(ExecutionMode type);
   ExecutionMode GetCoreType() const;
+  void SetReadMode(ReadMode mode);
+  ReadMode GetReadMode() const;
+  // Row batches the multi thread reader may queue ahead of its workers
+  void SetMaxInflightBatches(size_t count);
+  size_t GetMaxInflightBatches() const;
+  // Directory of the context snapshot cache; empty disables the cache
+  void SetSnapshotDir(const std::string& dir);
+  const std::string& GetSnapshotDir() const;
+  // Thread pool size (0 = hardware concurrency) and worker placement;
+  // read when the pool starts, at its first parallel stage
+  void SetWorkerThreads(size_t count);
+  size_t GetWorkerThreads() const;
+  void SetThreadPlacement(ThreadPlacement placement);
+  ThreadPlacement GetThreadPlacement() const;
 
   GlobalEnvironment(const GlobalEnvironment&) = delete;
   GlobalEnvironment& operator=(const GlobalEnvironment&) = delete;
@@ -35,6 +64,11 @@ class GlobalEnvironment {
  private:
   GlobalEnvironment() = default;
   ExecutionMode core_type_ = ExecutionMode::MULTI_THREAD;
+  ReadMode read_mode_ = ReadMode::CELL;
+  size_t max_inflight_batches_ = 8;
+  std::string snapshot_dir_;
+  size_t worker_threads_ = 0;
+  ThreadPlacement thread_placement_ = ThreadPlacement::NONE;
 };
 
 }  // namespace Environments
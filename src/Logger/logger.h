@@ -14,110 +14,405 @@
 #ifndef SRC_LOGGER_LOGGER_H_
 #define SRC_LOGGER_LOGGER_H_
 #include <atomic>
-#include <codecvt>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
 #include <fstream>
-#include <iostream>
-#include <locale>
 #include <memory>
 #include <mutex>
-#include <sstream>
 #include <string>
 #include <thread>
 
+// Lowest level compiled in (0 trace ... 4 error). Log sites below it are
+// discarded at compile time, arguments included.
+#ifndef LUKA_MIN_LOG_LEVEL
+#define LUKA_MIN_LOG_LEVEL 0
+#endif
+
+enum class LogLevel {
+  TRACE,
+  DEBUG,  // data structure dumps, including the regression logs
+  INFO,
+  WARN,
+  ERROR
+};
+
+// Logs through Logger::Log if level is compiled in and at or above the
+// runtime threshold. Otherwise the arguments are not evaluated.
+#define LUKA_LOG(level, ...)                                       \
+  do {                                                             \
+    if constexpr (static_cast<int>(level) >= LUKA_MIN_LOG_LEVEL) { \
+      if (Logger::IsEnabled(level)) {                              \
+        Logger::Log(__VA_ARGS__);                                  \
+      }                                                            \
+    }                                                              \
+  } while (0)
+
+#define LOG_TRACE(...) LUKA_LOG(LogLevel::TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) LUKA_LOG(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LUKA_LOG(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...) LUKA_LOG(LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LUKA_LOG(LogLevel::ERROR, __VA_ARGS__)
+
 // Logger with single output file
+//
+// Log formats the message on the calling thread and hands it to a
+// background writer through a bounded multi-producer ring. The writer
+// appends messages to the output file and stdout in batches, flushing
+// once per batch instead of once per message, and to the calling
+// thread's secondary log if one is open. Messages of one thread keep
+// their order. Finalize waits for calls already in Log, drains the ring
+// and stops the writer; later calls are dropped. The instance is never
+// destroyed, so threads still logging at exit do not touch freed memory.
+// Log itself writes unconditionally; the LOG_* macros filter by level.
 class Logger {
  public:
+  // Whether messages at level are compiled in and at or above the runtime threshold.
+  static bool IsEnabled(LogLevel level) {
+    return static_cast<int>(level) >= LUKA_MIN_LOG_LEVEL &&
+           static_cast<int>(level) >= GetInstance().level_.load(std::memory_order_relaxed);
+  }
+
+  // Runtime threshold; DEBUG by default, so the data dumps are written.
+  static void SetLevel(LogLevel level) {
+    GetInstance().level_.store(static_cast<int>(level), std::memory_order_relaxed);
+  }
+
+  static LogLevel GetLevel() { return static_cast<LogLevel>(GetInstance().level_.load(std::memory_order_relaxed)); }
+
   static void Log(const wchar_t* format, ...) {
-    if (!GetInstance().is_initialized_.load(std::memory_order_acquire)) {
+    ProducerScope producer;
+    if (!producer) {
       return;
     }
 
+    thread_local wchar_t buffer[kMaxMessage];
     va_list args;
     va_start(args, format);
-    wchar_t buffer[2048];
-    vswprintf(buffer, sizeof(buffer) / sizeof(wchar_t), format, args);
+    vswprintf(buffer, kMaxMessage, format, args);
     va_end(args);
-    std::wstring wstr_buffer(buffer);
-    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-    std::string str_buffer = converter.to_bytes(wstr_buffer);
+    // A truncated message is still terminated within the buffer
+    buffer[kMaxMessage - 1] = L'\0';
 
-    std::lock_guard<std::mutex> lock(GetInstance().mutex_);
-    if (GetInstance().file_stream_.is_open()) {
-      GetInstance().file_stream_ << str_buffer << std::flush;
-    }
-    if (GetThreadLocalStream().is_open()) {
-      GetThreadLocalStream() << str_buffer << std::flush;
-    }
-    printf("%s", str_buffer.c_str());
+    thread_local std::string utf8;
+    utf8.clear();
+    AppendUtf8(buffer, std::wcslen(buffer), utf8);
+    GetInstance().Push(RecordKind::kText, CurrentSecondary(), utf8.data(), utf8.size());
   }
 
   static void Log(const char* format, ...) {
-    if (!GetInstance().is_initialized_.load(std::memory_order_acquire)) {
+    ProducerScope producer;
+    if (!producer) {
       return;
     }
 
+    thread_local char buffer[kMaxMessage];
     va_list args;
     va_start(args, format);
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    vsnprintf(buffer, kMaxMessage, format, args);
     va_end(args);
 
-    std::lock_guard<std::mutex> lock(GetInstance().mutex_);
-    if (GetInstance().file_stream_.is_open()) {
-      GetInstance().file_stream_ << buffer << std::flush;
-    }
-    if (GetThreadLocalStream().is_open()) {
-      GetThreadLocalStream() << buffer << std::flush;
-    }
-    printf("%s", buffer);
+    GetInstance().Push(RecordKind::kText, CurrentSecondary(), buffer, std::strlen(buffer));
   }
 
+  // Also writes this thread's messages to file_name until StopSecondaryLog.
   static void StartSecondaryLog(const std::string& file_name) {
-    if (GetThreadLocalStream().is_open()) {
-      GetThreadLocalStream().close();
+    StopSecondaryLog();
+    ProducerScope producer;
+    if (!producer) {
+      return;
     }
-    GetThreadLocalStream().open(file_name, std::ios::out);
+    CurrentSecondary() = new SecondaryLog{file_name, std::ofstream()};
+    GetInstance().Push(RecordKind::kOpen, CurrentSecondary(), nullptr, 0);
   }
 
   static void StopSecondaryLog() {
-    if (GetThreadLocalStream().is_open()) {
-      GetThreadLocalStream().close();
+    if (SecondaryLog* secondary = CurrentSecondary()) {
+      CurrentSecondary() = nullptr;
+      {
+        ProducerScope producer;
+        if (producer) {
+          // The writer closes and frees it after the messages queued before
+          GetInstance().Push(RecordKind::kClose, secondary, nullptr, 0);
+          return;
+        }
+      }
+      // Records naming it may still be draining; once Finalize is done the
+      // writer has stopped and nothing else refers to it
+      std::lock_guard<std::mutex> lock(GetInstance().lifecycle_mutex_);
+      delete secondary;
     }
   }
 
   static void Initialize(const std::string& file_name) {
-    std::lock_guard<std::mutex> lock(GetInstance().mutex_);
-    GetInstance().file_stream_.open(file_name, std::ios::out);
-    GetInstance().is_initialized_.store(true, std::memory_order_release);
+    Logger& logger = GetInstance();
+    std::lock_guard<std::mutex> lock(logger.lifecycle_mutex_);
+    if (logger.writer_.joinable()) {
+      return;
+    }
+    logger.file_stream_.open(file_name, std::ios::out);
+    logger.should_stop_.store(false, std::memory_order_release);
+    logger.writer_ = std::thread([&logger]() { logger.WriterLoop(); });
+    logger.is_initialized_.store(true, std::memory_order_release);
+  }
+
+  // Blocks until every message logged before the call has been written.
+  static void Flush() {
+    Logger& logger = GetInstance();
+    if (!logger.writer_.joinable()) {
+      return;
+    }
+    uint64_t target = logger.enqueue_pos_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(logger.wake_mutex_);
+    logger.wake_.notify_one();
+    logger.flushed_.wait(lock, [&logger, target]() { return logger.written_pos_ >= target; });
   }
 
   static void Finalize() {
-    std::lock_guard<std::mutex> lock(GetInstance().mutex_);
-    if (GetInstance().file_stream_.is_open()) {
-      GetInstance().file_stream_.close();
+    Logger& logger = GetInstance();
+    std::lock_guard<std::mutex> lock(logger.lifecycle_mutex_);
+    if (!logger.writer_.joinable()) {
+      return;
+    }
+    // Producers count themselves in before checking is_initialized_, so
+    // once the count drops to zero no record can be claimed any more
+    logger.is_initialized_.store(false, std::memory_order_seq_cst);
+    while (logger.producers_.load(std::memory_order_seq_cst) != 0) {
+      std::this_thread::yield();
+    }
+    Flush();
+    {
+      std::lock_guard<std::mutex> wake_lock(logger.wake_mutex_);
+      logger.should_stop_.store(true, std::memory_order_release);
+    }
+    logger.wake_.notify_one();
+    logger.writer_.join();
+    if (logger.file_stream_.is_open()) {
+      logger.file_stream_.close();
     }
-    GetInstance().is_initialized_.store(false, std::memory_order_release);
   }
 
  private:
-  Logger() = default;
-  ~Logger() = default;
+  // Longest message, in characters; longer ones are truncated
+  static constexpr size_t kMaxMessage = 2048;
+  // Ring slots; a power of two
+  static constexpr size_t kCapacity = 4096;
+  // Bytes of message text stored in the slot itself; longer text goes to overflow
+  static constexpr size_t kInlineText = 240;
+  // Most records written per batch before the sinks are flushed
+  static constexpr size_t kMaxBatch = 1024;
+  // Safety net for a wake-up that raced with the writer going to sleep
+  static constexpr std::chrono::milliseconds kIdleWait{20};
+
+  enum class RecordKind : uint8_t { kText, kOpen, kClose };
+
+  struct SecondaryLog {
+    std::string file_name;
+    std::ofstream stream;
+  };
+
+  // Vyukov-style ring slot: sequence == position when free for the
+  // producer claiming position, position + 1 once the record is published
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence{0};
+    RecordKind kind = RecordKind::kText;
+    SecondaryLog* secondary = nullptr;
+    uint32_t size = 0;
+    std::string overflow;
+    char text[kInlineText];
+  };
+
+  Logger() : slots_(std::make_unique<Slot[]>(kCapacity)) {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
 
+  // Leaked on purpose: pool workers may still log while the process exits
   static Logger& GetInstance() {
-    static Logger instance;
-    return instance;
+    static Logger* instance = new Logger();
+    return *instance;
+  }
+
+  // Registers the calling thread as a producer for its lifetime. Converts
+  // to false if the logger is not running, in which case nothing may be pushed.
+  class ProducerScope {
+   public:
+    ProducerScope() : logger_(GetInstance()) {
+      logger_.producers_.fetch_add(1, std::memory_order_seq_cst);
+      active_ = logger_.is_initialized_.load(std::memory_order_seq_cst);
+    }
+    ~ProducerScope() { logger_.producers_.fetch_sub(1, std::memory_order_release); }
+    ProducerScope(const ProducerScope&) = delete;
+    ProducerScope& operator=(const ProducerScope&) = delete;
+
+    explicit operator bool() const { return active_; }
+
+   private:
+    Logger& logger_;
+    bool active_ = false;
+  };
+
+  static SecondaryLog*& CurrentSecondary() {
+    static thread_local SecondaryLog* secondary = nullptr;
+    return secondary;
+  }
+
+  // UTF-8 encoding of a UTF-32 (Linux wchar_t) string
+  static void AppendUtf8(const wchar_t* text, size_t length, std::string& out) {
+    for (size_t i = 0; i < length; ++i) {
+      uint32_t code = static_cast<uint32_t>(text[i]);
+      if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+      } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      } else if (code < 0x110000) {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+      } else {
+        out.append("\xEF\xBF\xBD");  // U+FFFD
+      }
+    }
+  }
+
+  // Claims the next slot, waiting while the ring is full, and publishes the record.
+  void Push(RecordKind kind, SecondaryLog* secondary, const char* text, size_t size) {
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos & (kCapacity - 1)];
+      int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // Full: the writer has not freed this slot yet
+        WakeWriter();
+        std::this_thread::yield();
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->kind = kind;
+    slot->secondary = secondary;
+    slot->size = static_cast<uint32_t>(size);
+    if (size <= kInlineText) {
+      std::memcpy(slot->text, text, size);
+    } else {
+      slot->overflow.assign(text, size);
+    }
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (writer_sleeping_.load(std::memory_order_seq_cst)) {
+      WakeWriter();
+    }
+  }
+
+  void WakeWriter() {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_.notify_one();
   }
 
-  static std::ofstream& GetThreadLocalStream() {
-    static thread_local std::ofstream stream;
-    return stream;
+  // Writes published records in ring order until the ring is empty and
+  // Finalize has asked it to stop.
+  void WriterLoop() {
+    std::string batch;
+    uint64_t dequeue_pos = written_pos_;
+    while (true) {
+      batch.clear();
+      size_t count = 0;
+      while (count < kMaxBatch) {
+        Slot& slot = slots_[dequeue_pos & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+          break;
+        }
+        WriteRecord(slot, batch);
+        slot.sequence.store(dequeue_pos + kCapacity, std::memory_order_release);
+        ++dequeue_pos;
+        ++count;
+      }
+
+      if (count > 0) {
+        if (file_stream_.is_open()) {
+          file_stream_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+          file_stream_.flush();
+        }
+        std::fwrite(batch.data(), 1, batch.size(), stdout);
+        std::fflush(stdout);
+        {
+          std::lock_guard<std::mutex> lock(wake_mutex_);
+          written_pos_ = dequeue_pos;
+        }
+        flushed_.notify_all();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      if (should_stop_.load(std::memory_order_acquire)) {
+        break;
+      }
+      writer_sleeping_.store(true, std::memory_order_seq_cst);
+      // Recheck after announcing the sleep so a producer that missed it is seen
+      if (slots_[dequeue_pos & (kCapacity - 1)].sequence.load(std::memory_order_seq_cst) != dequeue_pos + 1) {
+        wake_.wait_for(lock, kIdleWait);
+      }
+      writer_sleeping_.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  void WriteRecord(Slot& slot, std::string& batch) {
+    SecondaryLog* secondary = slot.secondary;
+    switch (slot.kind) {
+      case RecordKind::kOpen:
+        secondary->stream.open(secondary->file_name, std::ios::out);
+        break;
+      case RecordKind::kClose:
+        delete secondary;
+        break;
+      case RecordKind::kText: {
+        const char* text = slot.size <= kInlineText ? slot.text : slot.overflow.data();
+        batch.append(text, slot.size);
+        if (secondary && secondary->stream.is_open()) {
+          secondary->stream.write(text, slot.size);
+        }
+        if (slot.size > kInlineText) {
+          slot.overflow.clear();
+        }
+        break;
+      }
+    }
   }
 
   std::atomic<bool> is_initialized_{false};
+  // Threads between ProducerScope construction and destruction
+  std::atomic<int> producers_{0};
+  std::atomic<int> level_{static_cast<int>(LogLevel::DEBUG)};
   std::ofstream file_stream_;
-  std::mutex mutex_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+  alignas(64) std::atomic<bool> writer_sleeping_{false};
+  std::atomic<bool> should_stop_{false};
+  uint64_t written_pos_ = 0;  // Guarded by wake_mutex_
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  std::condition_variable flushed_;
+  std::mutex lifecycle_mutex_;
+  std::thread writer_;
 };
 #endif  // SRC_LOGGER_LOGGER_H_
@@ -22,6 +22,7 @@
 #include "CommandProcessor/command_processor.h"
 #include "Logger/logger.h"
 #include "Utility/string_utils.h"
+#include "Utility/symbol_table.h"
 int StartSequence(int argc, char* argv[]) {
   for (int i = 0; i < argc; i++) {
     printf("%s\n", argv[i]);
@@ -36,24 +37,25 @@ int StartSequence(int argc, char* argv[]) {
   try {
     config = YAML::LoadFile("./scenario.yaml");
   } catch (YAML::BadFile& e) {
-    Logger::Log(L"Config file error!");
+    LOG_ERROR(L"Config file error!");
     return -1;
   }
   // Run all the scenario items (environment or command)
   for (const auto& item : config) {
     if (item.first.as<std::string>() == "scenario") {
       for (const auto& cmd : item.second) {
-        Logger::Log(L"%ls\n", Ctw(cmd["command"].as<std::string>()).c_str());
+        LOG_INFO(L"%ls\n", Ctw(cmd["command"].as<std::string>()).c_str());
         // Some commands may not have a "name" field (e.g., calc_insurance_output with "files")
-        std::wstring name_value = L"";
+        Symbol name_value = SymbolTable::Intern(L"");
         if (cmd["name"]) {
-          name_value = Ctw(cmd["name"].as<std::string>());
+          name_value = SymbolTable::Intern(Ctw(cmd["name"].as<std::string>()));
         }
-        command_helper->ExecuteCommand(Ctw(cmd["command"].as<std::string>()),
+        command_helper->ExecuteCommand(SymbolTable::Intern(Ctw(cmd["command"].as<std::string>())),
                                        name_value, cmd);
       }
     }
   }
+  command_helper->LogArenaStats();
   Logger::Finalize();
   return 0;
 }
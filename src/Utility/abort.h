@@ -32,7 +32,8 @@ inline void Abort(const wchar_t* format, ...) {
   // Log the error message
   Logger::Log(L"FATAL ERROR: %ls", buffer);
 
-  // Terminate the program
+  // Write out everything logged so far, then terminate the program
+  Logger::Finalize();
   std::exit(EXIT_FAILURE);
 }
 
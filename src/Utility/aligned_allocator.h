@@ -0,0 +1,56 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_ALIGNED_ALLOCATOR_H_
+#define SRC_UTILITY_ALIGNED_ALLOCATOR_H_
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Allocator whose blocks start on a kAlignment-byte boundary, so column
+// arrays begin on a cache line and vector loads over them are aligned.
+template <typename T, size_t kAlignment = 64>
+class AlignedAllocator {
+ public:
+  static_assert(kAlignment >= alignof(T) && (kAlignment & (kAlignment - 1)) == 0,
+                "kAlignment must be a power of two no smaller than alignof(T)");
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, kAlignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, kAlignment>&) {}  // NOLINT(runtime/explicit)
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(kAlignment)));
+  }
+  void deallocate(T* data, size_t /*count*/) { ::operator delete(data, std::align_val_t(kAlignment)); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, kAlignment>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, kAlignment>&) const {
+    return false;
+  }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+#endif  // SRC_UTILITY_ALIGNED_ALLOCATOR_H_
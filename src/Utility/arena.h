@@ -0,0 +1,174 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_ARENA_H_
+#define SRC_UTILITY_ARENA_H_
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Monotonic bump allocator. Allocations are carved out of large blocks and
+// never freed one by one; every block is released when the arena is
+// destroyed. Not thread-safe: see ArenaSet for one arena per thread.
+class BumpArena {
+ public:
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  BumpArena() = default;
+  BumpArena(const BumpArena&) = delete;
+  BumpArena& operator=(const BumpArena&) = delete;
+
+  void* Allocate(size_t size, size_t alignment) {
+    ++allocation_count_;
+    bytes_allocated_ += size;
+    if (void* data = Bump(size, alignment)) {
+      return data;
+    }
+    // Requests larger than a block get a block of their own
+    NewBlock(std::max(kBlockSize, size + alignment));
+    return Bump(size, alignment);
+  }
+
+  // shared_ptr whose object and control block live in the arena.
+  template <typename T, typename... Args>
+  std::shared_ptr<T> MakeShared(Args&&... args);
+
+  size_t AllocationCount() const { return allocation_count_; }
+  size_t BytesAllocated() const { return bytes_allocated_; }
+  size_t BlockCount() const { return blocks_.size(); }
+
+ private:
+  void* Bump(size_t size, size_t alignment) {
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor_) + alignment - 1) & ~(uintptr_t{alignment} - 1);
+    if (!cursor_ || aligned + size > reinterpret_cast<uintptr_t>(limit_)) {
+      return nullptr;
+    }
+    cursor_ = reinterpret_cast<std::byte*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  void NewBlock(size_t size) {
+    blocks_.push_back(std::make_unique<std::byte[]>(size));
+    cursor_ = blocks_.back().get();
+    limit_ = cursor_ + size;
+  }
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;
+  std::byte* cursor_ = nullptr;
+  std::byte* limit_ = nullptr;
+  size_t allocation_count_ = 0;
+  size_t bytes_allocated_ = 0;
+};
+
+// Standard allocator over a BumpArena, for containers and allocate_shared.
+// Deallocation is a no-op; the memory goes with the arena.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(BumpArena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}  // NOLINT(runtime/explicit)
+
+  T* allocate(size_t count) { return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T))); }
+  void deallocate(T* /*data*/, size_t /*count*/) {}
+
+  BumpArena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  BumpArena* arena_;
+};
+
+template <typename T, typename... Args>
+std::shared_ptr<T> BumpArena::MakeShared(Args&&... args) {
+  return std::allocate_shared<T>(ArenaAllocator<T>(this), std::forward<Args>(args)...);
+}
+
+// One BumpArena per thread, released together. Each thread allocates from
+// its own arena without locking; the set's lock is only taken the first
+// time a thread asks for its arena.
+class ArenaSet {
+ public:
+  struct Stats {
+    size_t arenas = 0;
+    size_t blocks = 0;
+    size_t allocations = 0;
+    size_t bytes = 0;
+  };
+
+  ArenaSet() = default;
+  ArenaSet(const ArenaSet&) = delete;
+  ArenaSet& operator=(const ArenaSet&) = delete;
+
+  // The calling thread's arena.
+  BumpArena& Local() {
+    // Set ids are never reused, so a cached entry cannot name a destroyed set
+    thread_local uint64_t cached_id = 0;
+    thread_local BumpArena* cached_arena = nullptr;
+    if (cached_id == id_) {
+      return *cached_arena;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& arena = arenas_[std::this_thread::get_id()];
+    if (!arena) {
+      arena = std::make_unique<BumpArena>();
+    }
+    cached_id = id_;
+    cached_arena = arena.get();
+    return *arena;
+  }
+
+  // Totals over every thread's arena. Only exact while no thread allocates.
+  Stats GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.arenas = arenas_.size();
+    for (const auto& [thread, arena] : arenas_) {
+      stats.blocks += arena->BlockCount();
+      stats.allocations += arena->AllocationCount();
+      stats.bytes += arena->BytesAllocated();
+    }
+    return stats;
+  }
+
+ private:
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const uint64_t id_ = NextId();
+  mutable std::mutex mutex_;
+  // A thread id may be reused after its thread exits; the new thread then
+  // continues the old thread's arena, which is no longer in use.
+  std::unordered_map<std::thread::id, std::unique_ptr<BumpArena>> arenas_;
+};
+
+#endif  // SRC_UTILITY_ARENA_H_
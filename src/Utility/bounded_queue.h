@@ -0,0 +1,98 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_BOUNDED_QUEUE_H_
+#define SRC_UTILITY_BOUNDED_QUEUE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+/**
+ * @class BoundedQueue
+ * @brief Blocking FIFO with a fixed capacity, for producer/consumer pipelines
+ *
+ * Push blocks while the queue is full, Pop blocks while it is empty. After
+ * Close, Pop drains the remaining items and then returns false.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /**
+   * @brief BoundedQueue
+   * @param capacity Maximum number of queued items (at least 1)
+   */
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * @brief Add an item, waiting for a free slot
+   * @return false if the queue was closed
+   */
+  bool Push(T item) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+      if (closed_) {
+        return false;
+      }
+      items_.push(std::move(item));
+    }
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Take the oldest item, waiting for one to arrive
+   * @return false once the queue is closed and drained
+   */
+  bool Pop(T& item) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+      if (items_.empty()) {
+        return false;
+      }
+      item = std::move(items_.front());
+      items_.pop();
+    }
+    not_full_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief No more items will be pushed; wakes every waiting consumer
+   */
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::queue<T> items_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  bool closed_ = false;
+};
+
+#endif  // SRC_UTILITY_BOUNDED_QUEUE_H_
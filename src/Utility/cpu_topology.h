@@ -0,0 +1,153 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_CPU_TOPOLOGY_H_
+#define SRC_UTILITY_CPU_TOPOLOGY_H_
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// CPUs the process may run on, grouped by NUMA node. Nodes come from
+// /sys/devices/system/node; without it (or on a single-node machine)
+// every allowed CPU is in one node.
+class CpuTopology {
+ public:
+  static CpuTopology Detect() {
+    CpuTopology topology;
+    std::vector<int> allowed = AllowedCpus();
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+      std::string name = entry.path().filename().string();
+      if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+          !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        continue;
+      }
+      std::ifstream cpulist(entry.path() / "cpulist");
+      std::string list;
+      std::getline(cpulist, list);
+      std::vector<int> cpus;
+      for (int cpu : ParseCpuList(list)) {
+        if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+          cpus.push_back(cpu);
+        }
+      }
+      if (!cpus.empty()) {
+        topology.nodes_.push_back(std::move(cpus));
+      }
+    }
+    if (topology.nodes_.empty()) {
+      topology.nodes_.push_back(std::move(allowed));
+    }
+    // Directory order is arbitrary; order nodes by their first CPU
+    std::sort(topology.nodes_.begin(), topology.nodes_.end());
+    return topology;
+  }
+
+  size_t NodeCount() const { return nodes_.size(); }
+
+  size_t CpuCount() const {
+    size_t count = 0;
+    for (const auto& node : nodes_) {
+      count += node.size();
+    }
+    return count;
+  }
+
+  // CPUs for count workers filling one node before the next, so workers
+  // that share data also share a node's caches and memory.
+  std::vector<int> CompactCpus(size_t count) const {
+    std::vector<int> all;
+    for (const auto& node : nodes_) {
+      all.insert(all.end(), node.begin(), node.end());
+    }
+    std::vector<int> cpus(count);
+    for (size_t i = 0; i < count; ++i) {
+      cpus[i] = all[i % all.size()];
+    }
+    return cpus;
+  }
+
+  // CPUs for count workers dealt round-robin over the nodes, so every
+  // node's memory bandwidth is used.
+  std::vector<int> SpreadCpus(size_t count) const {
+    std::vector<int> cpus(count);
+    for (size_t i = 0; i < count; ++i) {
+      const auto& node = nodes_[i % nodes_.size()];
+      cpus[i] = node[(i / nodes_.size()) % node.size()];
+    }
+    return cpus;
+  }
+
+  // Restricts the calling thread to cpu. Returns false if that is refused.
+  static bool PinCurrentThread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+  }
+
+ private:
+  // Sorted CPUs in the process affinity mask
+  static std::vector<int> AllowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+    if (cpus.empty()) {
+      for (int cpu = 0; cpu < static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)); ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  // Parses a kernel CPU list such as "0-3,8-11"
+  static std::vector<int> ParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+      size_t end = list.find(',', pos);
+      if (end == std::string::npos) {
+        end = list.size();
+      }
+      std::string part = list.substr(pos, end - pos);
+      size_t dash = part.find('-');
+      if (!part.empty()) {
+        int first = std::atoi(part.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(part.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+          cpus.push_back(cpu);
+        }
+      }
+      pos = end + 1;
+    }
+    return cpus;
+  }
+
+  std::vector<std::vector<int>> nodes_;
+};
+
+#endif  // SRC_UTILITY_CPU_TOPOLOGY_H_
@@ -77,7 +77,7 @@ void PrintCudaDeviceInfo() {
 }
 
 
-bool ProcessRowsWithCuda(const std::vector<std::vector<std::pair<int, std::wstring>>>& row_data) {
+bool ProcessRowsWithCuda(const std::vector<CellRow>& row_data) {
   // Always print device info
   PrintCudaDeviceInfo();
   if (!IsCudaAvailable()) {
@@ -88,7 +88,11 @@ bool ProcessRowsWithCuda(const std::vector<std::vector<std::pair<int, std::wstri
   // Calculate total number of cells
   int total_cells = 0;
   for (const auto& row : row_data) {
-    total_cells += row.size();
+    for (const auto& cell_value : row.cells) {
+      if (!cell_value.IsEmpty()) {
+        total_cells++;
+      }
+    }
   }
 
   if (total_cells == 0) {
@@ -105,17 +109,16 @@ bool ProcessRowsWithCuda(const std::vector<std::vector<std::pair<int, std::wstri
   int cell_idx = 0;
   int current_row = 0;
   for (const auto& row : row_data) {
-    for (const auto& [col, cell_string] : row) {
-      h_row_indices[cell_idx] = current_row;
-      h_col_indices[cell_idx] = col;
-
-      // Try to convert string to number (example)
-      try {
-        h_values[cell_idx] = std::stof(std::string(cell_string.begin(),
-                                                   cell_string.end()));
-      } catch (...) {
-        h_values[cell_idx] = 0.0f;
+    for (size_t i = 0; i < row.cells.size(); ++i) {
+      const CellValue& cell_value = row.cells[i];
+      if (cell_value.IsEmpty()) {
+        continue;
       }
+      h_row_indices[cell_idx] = current_row;
+      h_col_indices[cell_idx] = row.first_col + static_cast<int>(i);
+
+      // Numeric cells are used as-is; text that is not a number becomes 0
+      h_values[cell_idx] = static_cast<float>(cell_value.AsDouble());
 
       cell_idx++;
     }
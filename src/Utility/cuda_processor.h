@@ -14,16 +14,16 @@
 #ifndef SRC_UTILITY_CUDA_PROCESSOR_H_
 #define SRC_UTILITY_CUDA_PROCESSOR_H_
 
-#include <string>
-#include <utility>
 #include <vector>
 
+#include "DataProcessor/cell_value.h"
+
 namespace CudaProcessor {
 
 // Parallel processing of Excel row data using CUDA
-// row_data: pairs of (column index, cell value) per row
+// row_data: typed (column index, cell value) pairs per row
 // Returns: true if processing succeeded, false otherwise
-bool ProcessRowsWithCuda(const std::vector<std::vector<std::pair<int, std::wstring>>>& row_data);
+bool ProcessRowsWithCuda(const std::vector<CellRow>& row_data);
 
 // Check if a CUDA device is available
 bool IsCudaAvailable();
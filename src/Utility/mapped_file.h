@@ -0,0 +1,71 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_MAPPED_FILE_H_
+#define SRC_UTILITY_MAPPED_FILE_H_
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file.
+// The contents are exposed as a string_view that stays valid while the
+// MappedFile is alive. An empty file is "open" with an empty view.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == 0) {
+      size_ = static_cast<size_t>(st.st_size);
+      if (size_ == 0) {
+        is_open_ = true;
+      } else {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+          // The file is scanned front to back
+          ::madvise(data, size_, MADV_SEQUENTIAL);
+          data_ = static_cast<const char*>(data);
+          is_open_ = true;
+        }
+      }
+    }
+    ::close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsOpen() const { return is_open_; }
+  std::string_view View() const { return data_ ? std::string_view(data_, size_) : std::string_view(); }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool is_open_ = false;
+};
+
+#endif  // SRC_UTILITY_MAPPED_FILE_H_
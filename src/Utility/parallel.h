@@ -0,0 +1,122 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_PARALLEL_H_
+#define SRC_UTILITY_PARALLEL_H_
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Utility/thread_pool.h"
+
+// Half-open index range [begin, end).
+struct IndexRange {
+  size_t begin = 0;
+  size_t end = 0;
+
+  size_t size() const { return end > begin ? end - begin : 0; }
+  bool empty() const { return size() == 0; }
+};
+
+// Splits range into chunks that shrink as the range is used up: each chunk
+// takes 1/(2 * workers) of what is left, but at least grain indices. Early
+// chunks are large to keep overhead low and the small tail chunks even out
+// the load. The split only depends on the arguments, so chunk i always
+// covers the same indices.
+inline std::vector<IndexRange> SplitRange(IndexRange range, size_t grain, size_t workers) {
+  grain = std::max<size_t>(grain, 1);
+  workers = std::max<size_t>(workers, 1);
+  std::vector<IndexRange> chunks;
+  for (size_t begin = range.begin; begin < range.end;) {
+    size_t remaining = range.end - begin;
+    size_t size = std::min(remaining, std::max(grain, remaining / (2 * workers)));
+    chunks.push_back(IndexRange{begin, begin + size});
+    begin += size;
+  }
+  return chunks;
+}
+
+// Runs fn(chunk) over chunks of range. Tasks claim the next chunk as they
+// finish the last one, so a chunk of expensive indices does not leave the
+// other workers idle. Chunks run in no particular order. A null pool runs
+// fn(range) once on the calling thread.
+template <typename Fn>
+void ParallelFor(IndexRange range, size_t grain, Fn&& fn, ThreadPool* pool = &ThreadPool::GetInstance()) {
+  if (range.empty()) {
+    return;
+  }
+  if (!pool) {
+    fn(range);
+    return;
+  }
+  std::vector<IndexRange> chunks = SplitRange(range, grain, pool->GetNumWorkers());
+  if (chunks.size() == 1) {
+    fn(chunks[0]);
+    return;
+  }
+  std::atomic<size_t> next_chunk{0};
+  TaskGroup group(*pool);
+  size_t runners = std::min(chunks.size(), pool->GetNumWorkers());
+  for (size_t i = 0; i < runners; ++i) {
+    group.Run([&chunks, &next_chunk, &fn]() {
+      for (size_t chunk; (chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < chunks.size();) {
+        fn(chunks[chunk]);
+      }
+    });
+  }
+  group.Wait();
+}
+
+// Maps every chunk of range to a T with map(chunk), then combines the
+// results with combine(T&& left, T&& right) in index order, pairwise and
+// level by level, so combine needs to be associative but not commutative.
+// Returns identity for an empty range. A null pool maps the whole range on
+// the calling thread.
+template <typename T, typename Map, typename Combine>
+T ParallelReduce(IndexRange range, size_t grain, T identity, Map&& map, Combine&& combine,
+                 ThreadPool* pool = &ThreadPool::GetInstance()) {
+  if (range.empty()) {
+    return identity;
+  }
+  if (!pool) {
+    return map(range);
+  }
+  std::vector<IndexRange> chunks = SplitRange(range, grain, pool->GetNumWorkers());
+  std::vector<T> results(chunks.size());
+  ParallelFor(
+      IndexRange{0, chunks.size()}, 1,
+      [&chunks, &results, &map](IndexRange part) {
+        for (size_t chunk = part.begin; chunk < part.end; ++chunk) {
+          results[chunk] = map(chunks[chunk]);
+        }
+      },
+      pool);
+  for (size_t stride = 1; stride < results.size(); stride *= 2) {
+    size_t pairs = (results.size() - stride + 2 * stride - 1) / (2 * stride);
+    ParallelFor(
+        IndexRange{0, pairs}, 1,
+        [&results, &combine, stride](IndexRange part) {
+          for (size_t pair = part.begin; pair < part.end; ++pair) {
+            size_t left = pair * 2 * stride;
+            results[left] = combine(std::move(results[left]), std::move(results[left + stride]));
+            results[left + stride] = T();
+          }
+        },
+        pool);
+  }
+  return std::move(results[0]);
+}
+
+#endif  // SRC_UTILITY_PARALLEL_H_
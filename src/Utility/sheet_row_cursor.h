@@ -0,0 +1,60 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_SHEET_ROW_CURSOR_H_
+#define SRC_UTILITY_SHEET_ROW_CURSOR_H_
+#include <OpenXLSX.hpp>
+#include <cstdint>
+
+// Sequential, forward-only cursor over the <sheetData> of a worksheet.
+// Each <row> node is located from the previous one (sibling walk), and the
+// cells of a row are exposed as an XLRowDataRange so every <c> node is
+// visited once instead of being searched for through wks.cell(ref).
+// Rows missing from the XML are skipped.
+class SheetRowCursor {
+ public:
+  SheetRowCursor(const OpenXLSX::XLWorksheet& wks, uint32_t first_row,
+                 uint32_t last_row, uint16_t first_col, uint16_t last_col)
+      : rows_(wks.rows(first_row, last_row)),
+        current_(rows_.begin()),
+        end_(rows_.end()),
+        first_col_(first_col),
+        last_col_(last_col) {}
+
+  // Moves to the next existing row. Returns false once the range is exhausted.
+  bool Next() {
+    if (started_) {
+      ++current_;
+    }
+    started_ = true;
+    while (current_ != end_ && !current_.rowExists()) {
+      ++current_;
+    }
+    return current_ != end_;
+  }
+
+  uint32_t RowNumber() const { return current_.rowNumber(); }
+
+  // Cells [first_col, last_col] of the current row, in column order.
+  OpenXLSX::XLRowDataRange Cells() { return current_->cells(first_col_, last_col_); }
+
+ private:
+  OpenXLSX::XLRowRange rows_;
+  OpenXLSX::XLRowIterator current_;
+  OpenXLSX::XLRowIterator end_;
+  uint16_t first_col_;
+  uint16_t last_col_;
+  bool started_ = false;
+};
+
+#endif  // SRC_UTILITY_SHEET_ROW_CURSOR_H_
@@ -16,6 +16,7 @@
 #include <codecvt>
 #include <locale>
 #include <string>
+#include <string_view>
 
 class StringUtils {
  public:
@@ -25,6 +26,12 @@ class StringUtils {
     return converter.from_bytes(str);
   }
 
+  // Convert a UTF-8 view (e.g. into the shared-string cache) to std::wstring
+  static std::wstring CharToWide(std::string_view str) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+    return converter.from_bytes(str.data(), str.data() + str.size());
+  }
+
   // Convert std::wstring to std::string (UTF-8)
   static std::string WideToChar(const std::wstring& str) {
     std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
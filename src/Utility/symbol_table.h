@@ -0,0 +1,126 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_SYMBOL_TABLE_H_
+#define SRC_UTILITY_SYMBOL_TABLE_H_
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interned name: a compact id standing for one string for the whole process.
+// Equal strings always intern to the same id, so symbols compare and hash
+// as integers.
+class Symbol {
+ public:
+  constexpr Symbol() = default;
+  constexpr explicit Symbol(uint32_t id) : id_(id) {}
+
+  constexpr uint32_t Id() const { return id_; }
+  constexpr bool IsValid() const { return id_ != kInvalidId; }
+  constexpr bool operator==(Symbol other) const { return id_ == other.id_; }
+  constexpr bool operator!=(Symbol other) const { return id_ != other.id_; }
+
+  // The interned string.
+  const std::wstring& Name() const;
+
+ private:
+  static constexpr uint32_t kInvalidId = UINT32_MAX;
+  uint32_t id_ = kInvalidId;
+};
+
+template <>
+struct std::hash<Symbol> {
+  size_t operator()(Symbol symbol) const { return symbol.Id(); }
+};
+
+// Names the pipeline refers to in code. They are interned first, in this
+// order, so each constant equals SymbolTable::Intern of its string and
+// ids below kWellKnownCount can index fixed tables.
+namespace Symbols {
+// Data structure types (also the names of their contexts)
+inline constexpr Symbol kCode{0};
+inline constexpr Symbol kQx{1};
+inline constexpr Symbol kTermination{2};
+inline constexpr Symbol kExpense{3};
+inline constexpr Symbol kSRatio{4};
+inline constexpr Symbol kTable{5};
+inline constexpr Symbol kInsuranceResult{6};
+inline constexpr Symbol kInsuranceOutput{7};
+inline constexpr Symbol kExpenseOutput{8};
+inline constexpr uint32_t kWellKnownCount = 9;
+
+inline constexpr std::array<const wchar_t*, kWellKnownCount> kWellKnownNames = {
+    L"Code", L"Qx", L"Termination", L"Expense", L"SRatio",
+    L"Table", L"InsuranceResult", L"InsuranceOutput", L"ExpenseOutput"};
+}  // namespace Symbols
+
+// Process-wide string interner. Interning takes a shared lock (exclusive
+// only for a new string); names are stored in a deque, so the views used
+// as map keys and the references handed out by Name stay valid.
+class SymbolTable {
+ public:
+  static Symbol Intern(std::wstring_view name) { return Instance().InternImpl(name); }
+
+  static const std::wstring& Name(Symbol symbol) { return Instance().NameImpl(symbol); }
+
+ private:
+  SymbolTable() {
+    for (const wchar_t* name : Symbols::kWellKnownNames) {
+      InternImpl(name);
+    }
+  }
+
+  static SymbolTable& Instance() {
+    static SymbolTable instance;
+    return instance;
+  }
+
+  Symbol InternImpl(std::wstring_view name) {
+    {
+      std::shared_lock lock(mutex_);
+      auto it = ids_.find(name);
+      if (it != ids_.end()) {
+        return it->second;
+      }
+    }
+    std::unique_lock lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    Symbol symbol(static_cast<uint32_t>(names_.size()));
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), symbol);
+    return symbol;
+  }
+
+  const std::wstring& NameImpl(Symbol symbol) {
+    static const std::wstring kInvalidName = L"<invalid>";
+    std::shared_lock lock(mutex_);
+    return symbol.Id() < names_.size() ? names_[symbol.Id()] : kInvalidName;
+  }
+
+  std::shared_mutex mutex_;
+  std::deque<std::wstring> names_;
+  std::unordered_map<std::wstring_view, Symbol> ids_;
+};
+
+inline const std::wstring& Symbol::Name() const { return SymbolTable::Name(*this); }
+
+#endif  // SRC_UTILITY_SYMBOL_TABLE_H_
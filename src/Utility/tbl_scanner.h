@@ -0,0 +1,181 @@
+// ============================================================================
+// Copyright © 2025 Luka. All rights reserved.
+// SPDX-License-Identifier: Proprietary
+//
+// This software is proprietary and confidential.
+// Redistribution, modification, or any form of reuse without explicit
+// written permission from Luka is strictly prohibited.
+//
+// This file is a component of the Luka Risk Intelligence Suite™.
+// Unauthorized use may result in legal action.
+//
+// Developed by: Luka
+// ============================================================================
+#ifndef SRC_UTILITY_TBL_SCANNER_H_
+#define SRC_UTILITY_TBL_SCANNER_H_
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LUKA_TBL_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+// Byte-level kernels for tab-separated integer text (.tbl files).
+// Each instruction set has its own kernels; the SIMD ones are compiled with
+// per-function target attributes so the binary still runs on any x86-64,
+// and Active() picks the widest set the CPU supports at runtime.
+// SIMD loads never read past `end`; short tails fall back to scalar code.
+class TblScanner {
+ public:
+  enum class SimdLevel {
+    SCALAR,
+    SSE42,
+    AVX2
+  };
+
+  struct Kernels {
+    // First '\t', '\n' or '\r' in [p, end), or end.
+    const char* (*find_delimiter)(const char* p, const char* end);
+    // Digit run starting at p, as a value; returns the first non-digit.
+    const char* (*parse_digits)(const char* p, const char* end, uint64_t* value);
+  };
+
+  static SimdLevel DetectSimdLevel() {
+#ifdef LUKA_TBL_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+      return SimdLevel::SSE42;
+    }
+#endif
+    return SimdLevel::SCALAR;
+  }
+
+  static const wchar_t* SimdLevelName(SimdLevel level) {
+    switch (level) {
+      case SimdLevel::AVX2:
+        return L"AVX2";
+      case SimdLevel::SSE42:
+        return L"SSE4.2";
+      default:
+        return L"scalar";
+    }
+  }
+
+  // Kernels for a given level. Levels this build cannot provide map to scalar.
+  static const Kernels& ForLevel(SimdLevel level) {
+    static const Kernels kScalar{FindDelimiterScalar, ParseDigitsScalar};
+#ifdef LUKA_TBL_SCANNER_X86
+    static const Kernels kSse42{FindDelimiterSse42, ParseDigitsSse42};
+    static const Kernels kAvx2{FindDelimiterAvx2, ParseDigitsSse42};
+    switch (level) {
+      case SimdLevel::AVX2:
+        return kAvx2;
+      case SimdLevel::SSE42:
+        return kSse42;
+      default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return kScalar;
+  }
+
+  // Kernels for the widest level supported by this CPU, detected once.
+  static const Kernels& Active() {
+    static const Kernels& kernels = ForLevel(DetectSimdLevel());
+    return kernels;
+  }
+
+ private:
+  static bool IsDelimiter(char c) { return c == '\t' || c == '\n' || c == '\r'; }
+
+  static const char* FindDelimiterScalar(const char* p, const char* end) {
+    while (p < end && !IsDelimiter(*p)) {
+      ++p;
+    }
+    return p;
+  }
+
+  static const char* ParseDigitsScalar(const char* p, const char* end, uint64_t* value) {
+    uint64_t result = 0;
+    while (p < end && static_cast<unsigned char>(*p - '0') < 10) {
+      result = result * 10 + static_cast<unsigned char>(*p - '0');
+      ++p;
+    }
+    *value = result;
+    return p;
+  }
+
+#ifdef LUKA_TBL_SCANNER_X86
+  // PCMPESTRI "equal any" against the delimiter set, 16 bytes per step.
+  __attribute__((target("sse4.2"))) static const char* FindDelimiterSse42(const char* p, const char* end) {
+    const __m128i delimiters = _mm_setr_epi8('\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    while (end - p >= 16) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      int index = _mm_cmpestri(delimiters, 3, chunk, 16,
+                               _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+      if (index < 16) {
+        return p + index;
+      }
+      p += 16;
+    }
+    return FindDelimiterScalar(p, end);
+  }
+
+  // Three byte compares per 32-byte block, first hit from the movemask.
+  __attribute__((target("avx2"))) static const char* FindDelimiterAvx2(const char* p, const char* end) {
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    while (end - p >= 32) {
+      __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, tab), _mm256_cmpeq_epi8(chunk, lf)),
+                                     _mm256_cmpeq_epi8(chunk, cr));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+      if (mask != 0) {
+        return p + __builtin_ctz(mask);
+      }
+      p += 32;
+    }
+    return FindDelimiterSse42(p, end);
+  }
+
+  // Converts a run of up to 15 digits in one go: the run is right-aligned in
+  // a register, then digit pairs, quads and octets are combined with
+  // multiply-add. Longer runs and short tails take the scalar loop.
+  __attribute__((target("sse4.2"))) static const char* ParseDigitsSse42(const char* p, const char* end,
+                                                                        uint64_t* value) {
+    if (end - p < 16) {
+      return ParseDigitsScalar(p, end, value);
+    }
+    __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8('0'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(is_digit));
+    int length = __builtin_ctz(~mask);
+    if (length >= 16) {
+      return ParseDigitsScalar(p, end, value);
+    }
+
+    // Lane i takes digit i - (16 - length); negative indices zero the lane.
+    const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i aligned = _mm_shuffle_epi8(digits, _mm_add_epi8(lanes, _mm_set1_epi8(static_cast<char>(length - 16))));
+
+    __m128i pairs = _mm_maddubs_epi16(aligned, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    __m128i packed = _mm_packus_epi32(quads, quads);
+    __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+    uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    uint64_t low = static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+    *value = high * 100000000ULL + low;
+    return p + length;
+  }
+#endif
+};
+
+#endif  // SRC_UTILITY_TBL_SCANNER_H_
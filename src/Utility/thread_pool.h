@@ -16,45 +16,160 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <cstddef>
+#include <exception>
+#include <future>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "Environments/global_environment.h"
+#include "Logger/logger.h"
+#include "Utility/cpu_topology.h"
+
+#ifdef NUMA_ENABLED
+#include <numa.h>
+#endif
+
+/**
+ * @class Task
+ * @brief Move-only void() callable with inline storage
+ *
+ * Callables up to kInlineSize bytes are stored in the task itself, so
+ * scheduling one does not allocate. Larger ones are moved to the heap.
+ */
+class Task {
+ public:
+  static constexpr size_t kInlineSize = 64;
+
+  Task() = default;
+
+  template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+  Task(F&& function) {  // NOLINT(runtime/explicit)
+    using Fn = std::decay_t<F>;
+    if constexpr (IsInline<Fn>()) {
+      new (storage_) Fn(std::forward<F>(function));
+      ops_ = &kInlineOps<Fn>;
+    } else {
+      new (storage_) Fn*(new Fn(std::forward<F>(function)));
+      ops_ = &kHeapOps<Fn>;
+    }
+  }
+
+  Task(Task&& other) noexcept { MoveFrom(other); }
+
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() { ops_->invoke(storage_); }
+
+ private:
+  struct Ops {
+    void (*invoke)(void* storage);
+    void (*move)(void* target, void* source);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Fn>
+  static constexpr bool IsInline() {
+    return sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Fn>;
+  }
+
+  template <typename Fn>
+  static constexpr Ops kInlineOps = {
+      [](void* storage) { (*std::launder(static_cast<Fn*>(storage)))(); },
+      [](void* target, void* source) {
+        Fn* function = std::launder(static_cast<Fn*>(source));
+        new (target) Fn(std::move(*function));
+        function->~Fn();
+      },
+      [](void* storage) { std::launder(static_cast<Fn*>(storage))->~Fn(); },
+  };
+
+  template <typename Fn>
+  static constexpr Ops kHeapOps = {
+      [](void* storage) { (**static_cast<Fn**>(storage))(); },
+      [](void* target, void* source) { *static_cast<Fn**>(target) = *static_cast<Fn**>(source); },
+      [](void* storage) { delete *static_cast<Fn**>(storage); },
+  };
+
+  void MoveFrom(Task& other) {
+    if (other.ops_) {
+      other.ops_->move(storage_, other.storage_);
+      ops_ = std::exchange(other.ops_, nullptr);
+    }
+  }
+
+  void Reset() {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+  const Ops* ops_ = nullptr;
+};
+
 /**
  * @class ThreadPool
- * @brief Lock-free based thread pool
+ * @brief Work-stealing thread pool
+ *
+ * Each worker owns a deque of tasks behind its own lock. A worker runs the
+ * newest task of its own deque first and, when that is empty, steals the
+ * oldest task of another worker's deque. Tasks scheduled from a worker go
+ * to its own deque; tasks from other threads are spread round-robin.
+ *
+ * The process shares one pool, GetInstance(), which is started on first
+ * use and lives until the process exits. Use a TaskGroup to wait for tasks.
+ * Workers may be pinned to CPUs; a pinned worker allocates from its own
+ * NUMA node, so the contexts it builds stay local to it.
  */
 class ThreadPool {
  public:
   /**
    * @brief ThreadPool
-   * @param num_threads
+   * @param num_threads Worker count, hardware concurrency if 0
+   * @param worker_cpus CPU to pin each worker to; empty leaves them unpinned
    */
-  explicit ThreadPool(size_t num_threads = 0) {
+  explicit ThreadPool(size_t num_threads = 0, std::vector<int> worker_cpus = {})
+      : worker_cpus_(std::move(worker_cpus)) {
     if (num_threads == 0) {
-      num_threads = std::thread::hardware_concurrency();
-      if (num_threads == 0) {
-        num_threads = 4;
-      }
+      num_threads = DefaultThreadCount();
     }
 
+    queues_ = std::vector<WorkQueue>(num_threads);
+    workers_.reserve(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
-      workers_.emplace_back([this]() { WorkerLoop(); });
+      workers_.emplace_back([this, i]() { WorkerLoop(i); });
     }
   }
 
   /**
-   * @brief ThreadPool Destructor
+   * @brief ThreadPool Destructor, runs every queued task before returning
    */
   ~ThreadPool() {
     {
-      std::lock_guard<std::mutex> lock(queue_mutex_);
-      should_stop_.store(true, std::memory_order_release);
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      should_stop_ = true;
     }
-    condition_.notify_all();
+    wake_.notify_all();
 
     for (auto& worker : workers_) {
       if (worker.joinable()) {
@@ -63,19 +178,73 @@ class ThreadPool {
     }
   }
 
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief The process-wide pool
+   *
+   * Sized and placed by the worker_threads and thread_placement
+   * environments when it starts. Never destroyed: Abort() may exit from a
+   * worker, which could not join itself, so the workers simply end with
+   * the process.
+   */
+  static ThreadPool& GetInstance() {
+    static ThreadPool* instance = CreateInstance();
+    return *instance;
+  }
+
+  /**
+   * @brief Whether GetInstance() has started the process-wide pool
+   */
+  static bool IsInstanceStarted() { return instance_started_.load(std::memory_order_acquire); }
+
   /**
-   * @brief Add thread pool task
-   * @param task std::function<void()>)
+   * @brief Schedule a task without a way to wait for it
+   * @param task Callable taking no arguments
    */
-  void EnqueueTask(std::function<void()> task) {
+  void EnqueueTask(Task task) {
+    size_t index;
+    if (current_pool_ == this) {
+      index = current_index_;
+    } else {
+      index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
     {
-      std::lock_guard<std::mutex> lock(queue_mutex_);
-      if (should_stop_.load(std::memory_order_acquire)) {
-        return;
-      }
-      task_queue_.push(std::move(task));
+      std::lock_guard<std::mutex> lock(queues_[index].mutex);
+      queues_[index].tasks.PushBack(std::move(task));
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+      // Pairs with the predicate check in WorkerLoop so the wake-up is not lost
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
     }
-    condition_.notify_one();
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief Schedule a task and get a future of its result
+   * @param function Callable taking no arguments
+   * @return Future holding the result, or the exception it threw
+   */
+  template <typename F>
+  std::future<std::invoke_result_t<std::decay_t<F>&>> Submit(F&& function) {
+    using Result = std::invoke_result_t<std::decay_t<F>&>;
+    std::promise<Result> promise;
+    std::future<Result> future = promise.get_future();
+    EnqueueTask([promise = std::move(promise), function = std::forward<F>(function)]() mutable {
+      try {
+        if constexpr (std::is_void_v<Result>) {
+          function();
+          promise.set_value();
+        } else {
+          promise.set_value(function());
+        }
+      } catch (...) {
+        promise.set_exception(std::current_exception());
+      }
+    });
+    return future;
   }
 
   /**
@@ -85,41 +254,257 @@ class ThreadPool {
   size_t GetNumWorkers() const { return workers_.size(); }
 
  private:
+  friend class TaskGroup;
+
+  static size_t DefaultThreadCount() {
+    size_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 4;
+  }
+
+  static ThreadPool* CreateInstance() {
+    const auto& environment = Environments::GlobalEnvironment::GetInstance();
+    size_t num_threads = environment.GetWorkerThreads();
+    if (num_threads == 0) {
+      num_threads = DefaultThreadCount();
+    }
+
+    std::vector<int> worker_cpus;
+    Environments::ThreadPlacement placement = environment.GetThreadPlacement();
+    if (placement != Environments::ThreadPlacement::NONE) {
+      CpuTopology topology = CpuTopology::Detect();
+      worker_cpus = placement == Environments::ThreadPlacement::SPREAD ? topology.SpreadCpus(num_threads)
+                                                                       : topology.CompactCpus(num_threads);
+      LOG_INFO(L"Thread pool: %zu workers pinned %ls over %zu CPUs on %zu NUMA node(s)\n", num_threads,
+               placement == Environments::ThreadPlacement::SPREAD ? L"spread" : L"compact", topology.CpuCount(),
+               topology.NodeCount());
+    }
+    instance_started_.store(true, std::memory_order_release);
+    return new ThreadPool(num_threads, std::move(worker_cpus));
+  }
+
+  /**
+   * @brief Pin the calling worker to its CPU and keep its allocations on that CPU's node
+   */
+  void PlaceWorker(size_t index) {
+    if (index >= worker_cpus_.size()) {
+      return;
+    }
+    if (!CpuTopology::PinCurrentThread(worker_cpus_[index])) {
+      LOG_WARN(L"Warning: could not pin worker %zu to CPU %d\n", index, worker_cpus_[index]);
+      return;
+    }
+    // Once pinned, first touch already puts the worker's pages on its node;
+    // libnuma also overrides a policy inherited from e.g. numactl --interleave
+#ifdef NUMA_ENABLED
+    if (numa_available() >= 0) {
+      numa_set_localalloc();
+    }
+#endif
+  }
+
+  // Growable ring buffer of tasks. Its storage is kept between tasks, so a
+  // queue only allocates when it reaches a new high-water mark.
+  class TaskRing {
+   public:
+    bool empty() const { return count_ == 0; }
+
+    void PushBack(Task task) {
+      if (count_ == slots_.size()) {
+        Grow();
+      }
+      slots_[(head_ + count_) % slots_.size()] = std::move(task);
+      ++count_;
+    }
+
+    Task PopBack() {
+      --count_;
+      return std::move(slots_[(head_ + count_) % slots_.size()]);
+    }
+
+    Task PopFront() {
+      Task task = std::move(slots_[head_]);
+      head_ = (head_ + 1) % slots_.size();
+      --count_;
+      return task;
+    }
+
+   private:
+    void Grow() {
+      std::vector<Task> slots(slots_.empty() ? 16 : slots_.size() * 2);
+      for (size_t i = 0; i < count_; ++i) {
+        slots[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+      }
+      slots_ = std::move(slots);
+      head_ = 0;
+    }
+
+    std::vector<Task> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+  };
+
+  // One cache line per queue so workers locking their own do not collide
+  struct alignas(64) WorkQueue {
+    std::mutex mutex;
+    TaskRing tasks;
+  };
+
+  /**
+   * @brief Take a task: the newest of the own queue, else the oldest of another
+   * @param index Own queue, or queues_.size() for a thread outside the pool
+   */
+  bool TakeTask(size_t index, Task& task) {
+    if (queued_.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    if (index < queues_.size()) {
+      std::lock_guard<std::mutex> lock(queues_[index].mutex);
+      if (!queues_[index].tasks.empty()) {
+        task = queues_[index].tasks.PopBack();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    size_t start = index < queues_.size() ? index + 1 : 0;
+    for (size_t i = 0; i < queues_.size(); ++i) {
+      WorkQueue& victim = queues_[(start + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.PopFront();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Run one queued task on the calling thread, if there is one
+   */
+  bool TryRunOne() {
+    Task task;
+    if (!TakeTask(current_pool_ == this ? current_index_ : queues_.size(), task)) {
+      return false;
+    }
+    task();
+    return true;
+  }
+
   /**
    * @brief Worker main loop
    */
-  void WorkerLoop() {
+  void WorkerLoop(size_t index) {
+    current_pool_ = this;
+    current_index_ = index;
+    PlaceWorker(index);
     while (true) {
-      std::unique_lock<std::mutex> lock(queue_mutex_);
-
-      // Wait for tasks or stop signal
-      condition_.wait(lock, [this]() {
-        return !task_queue_.empty() ||
-               should_stop_.load(std::memory_order_acquire);
-      });
+      Task task;
+      if (TakeTask(index, task)) {
+        task();
+        continue;
+      }
 
-      if (should_stop_.load(std::memory_order_acquire) &&
-          task_queue_.empty()) {
+      // Sleep until a task is scheduled or the pool stops
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [this]() { return queued_.load(std::memory_order_acquire) > 0 || should_stop_; });
+      if (should_stop_ && queued_.load(std::memory_order_acquire) == 0) {
         break;
       }
+    }
+  }
 
-      if (task_queue_.empty()) {
-        continue;
+  static inline thread_local ThreadPool* current_pool_ = nullptr;
+  static inline thread_local size_t current_index_ = 0;
+  static inline std::atomic<bool> instance_started_{false};
+
+  std::vector<int> worker_cpus_;
+  std::vector<WorkQueue> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> queued_{0};
+  std::atomic<size_t> next_queue_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool should_stop_ = false;
+};
+
+/**
+ * @class TaskGroup
+ * @brief Tasks on a ThreadPool that can be waited for together
+ *
+ * Wait() runs queued tasks on the calling thread until every task of the
+ * group has finished, so a task may itself wait for a nested group without
+ * tying up a worker. The first exception a task throws is rethrown by
+ * Wait(). The destructor waits as well, but drops that exception.
+ */
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool = ThreadPool::GetInstance()) : pool_(pool) {}
+
+  ~TaskGroup() { WaitAll(); }
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /**
+   * @brief Schedule a task in this group
+   * @param function Callable taking no arguments
+   */
+  template <typename F>
+  void Run(F&& function) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.EnqueueTask([this, function = std::forward<F>(function)]() mutable {
+      std::exception_ptr exception;
+      try {
+        function();
+      } catch (...) {
+        exception = std::current_exception();
       }
+      Finish(exception);
+    });
+  }
+
+  /**
+   * @brief Wait for every task scheduled so far
+   */
+  void Wait() {
+    WaitAll();
+    if (exception_) {
+      std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+  }
 
-      std::function<void()> task = std::move(task_queue_.front());
-      task_queue_.pop();
-      lock.unlock();
+  ThreadPool& Pool() const { return pool_; }
 
-      task();
+ private:
+  void Finish(const std::exception_ptr& exception) {
+    // Decremented under the lock: once a waiter has seen zero and taken the
+    // lock, no task touches the group again, so it may be destroyed
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (exception && !exception_) {
+      exception_ = exception;
+    }
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      done_.notify_all();
     }
   }
 
-  std::vector<std::thread> workers_;
-  std::queue<std::function<void()>> task_queue_;
-  std::mutex queue_mutex_;
-  std::condition_variable condition_;
-  std::atomic<bool> should_stop_{false};
+  void WaitAll() {
+    while (pending_.load(std::memory_order_acquire) > 0) {
+      if (pool_.TryRunOne()) {
+        continue;
+      }
+      // Nothing left to help with: the remaining tasks are running elsewhere
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this]() { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+
+  ThreadPool& pool_;
+  std::atomic<size_t> pending_{0};
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::exception_ptr exception_;
 };
 
 #endif  // SRC_UTILITY_THREAD_POOL_H_